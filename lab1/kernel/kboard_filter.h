@@ -0,0 +1,194 @@
+#ifndef _KBOARD_FILTER_H
+#define _KBOARD_FILTER_H
+
+// 복사 경로의 classic BPF 필터 (os_kboard.c 의 kb_set_filter, KboardModule.c 의 KBOARD_IOC_SET_FILTER)
+// 복사할 값마다 struct kb_filter_data 를 컨텍스트로 필터를 실행하고 돌려준 값을 int 로 보아
+// 0 이상이면 그 값을 저장(받거나 바꿈), 음수이면 저장하지 않고 버림, 버린 값의 복사는 성공으로 처리
+// 필터가 붙어 있으면 음수 값 검사 대신 필터가 판단하고, 필터가 없으면 음수 값은 이전처럼 거부
+// 필터는 컨텍스트를 4 바이트 단위의 ld [offset] 으로만 읽을 수 있고 사용할 수 있는 명령은 seccomp 필터와 같음
+// 예) 100 미만은 버리고 나머지는 그대로 받는 필터
+//     ld [0]; jge #100, accept, drop; accept: ret a; drop: ret #0xffffffff
+// 유저 프로그램과 함께 사용하므로 커널 전용 부분은 __KERNEL__ 안에 둠
+
+struct kb_filter_data
+{
+	int Item;					// 복사할 값
+	int Pid;					// 복사하는 프로세스의 tgid
+	unsigned long long Cgroup;	// 복사하는 프로세스의 cgroup v2 id, x86_64 에서는 하위 32 비트가 offset 8
+};
+
+#ifdef __KERNEL__
+
+#include <linux/cgroup.h>
+#include <linux/filter.h>
+#include <linux/mutex.h>
+#include <linux/rcupdate.h>
+#include <linux/sched.h>
+#include <linux/uaccess.h>
+
+#define KB_FILTER_DROPPED (1)	// kb_filter_apply: 필터가 값을 버림
+
+// bpf_prog_create_from_user 가 기본 검사를 마친 뒤 호출, seccomp_check_filter 와 같은 방식
+// 패킷을 읽는 명령은 막고 ld [k] 는 컨텍스트에서 읽는 명령으로, 길이는 컨텍스트 크기로 바꿈
+static inline int kb_filter_check(struct sock_filter *filter, unsigned int length)
+{
+	struct sock_filter *insn;
+	unsigned int pc;
+
+	for (pc = 0; pc < length; pc++)
+	{
+		insn = &filter[pc];
+
+		switch (insn->code)
+		{
+		case BPF_LD | BPF_W | BPF_ABS:
+			// 4 바이트로 정렬되고 컨텍스트 안에 있어야 함
+			if (insn->k >= sizeof(struct kb_filter_data) || (insn->k & 3) != 0)
+			{
+				return -EINVAL;
+			}
+			insn->code = BPF_LDX | BPF_W | BPF_ABS;
+			continue;
+
+		case BPF_LD | BPF_W | BPF_LEN:
+			insn->code = BPF_LD | BPF_IMM;
+			insn->k = sizeof(struct kb_filter_data);
+			continue;
+
+		case BPF_LDX | BPF_W | BPF_LEN:
+			insn->code = BPF_LDX | BPF_IMM;
+			insn->k = sizeof(struct kb_filter_data);
+			continue;
+
+		case BPF_RET | BPF_K:
+		case BPF_RET | BPF_A:
+		case BPF_ALU | BPF_ADD | BPF_K:
+		case BPF_ALU | BPF_ADD | BPF_X:
+		case BPF_ALU | BPF_SUB | BPF_K:
+		case BPF_ALU | BPF_SUB | BPF_X:
+		case BPF_ALU | BPF_MUL | BPF_K:
+		case BPF_ALU | BPF_MUL | BPF_X:
+		case BPF_ALU | BPF_DIV | BPF_K:
+		case BPF_ALU | BPF_DIV | BPF_X:
+		case BPF_ALU | BPF_AND | BPF_K:
+		case BPF_ALU | BPF_AND | BPF_X:
+		case BPF_ALU | BPF_OR | BPF_K:
+		case BPF_ALU | BPF_OR | BPF_X:
+		case BPF_ALU | BPF_XOR | BPF_K:
+		case BPF_ALU | BPF_XOR | BPF_X:
+		case BPF_ALU | BPF_LSH | BPF_K:
+		case BPF_ALU | BPF_LSH | BPF_X:
+		case BPF_ALU | BPF_RSH | BPF_K:
+		case BPF_ALU | BPF_RSH | BPF_X:
+		case BPF_ALU | BPF_NEG:
+		case BPF_LD | BPF_IMM:
+		case BPF_LDX | BPF_IMM:
+		case BPF_MISC | BPF_TAX:
+		case BPF_MISC | BPF_TXA:
+		case BPF_LD | BPF_MEM:
+		case BPF_LDX | BPF_MEM:
+		case BPF_ST:
+		case BPF_STX:
+		case BPF_JMP | BPF_JA:
+		case BPF_JMP | BPF_JEQ | BPF_K:
+		case BPF_JMP | BPF_JEQ | BPF_X:
+		case BPF_JMP | BPF_JGE | BPF_K:
+		case BPF_JMP | BPF_JGE | BPF_X:
+		case BPF_JMP | BPF_JGT | BPF_K:
+		case BPF_JMP | BPF_JGT | BPF_X:
+		case BPF_JMP | BPF_JSET | BPF_K:
+		case BPF_JMP | BPF_JSET | BPF_X:
+			continue;
+
+		default:
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+// 현재 프로세스의 cgroup v2 id
+static inline unsigned long long kb_filter_cgroup(void)
+{
+#ifdef CONFIG_CGROUPS
+	unsigned long long id;
+
+	rcu_read_lock();
+	id = cgroup_id(task_dfl_cgroup(current));
+	rcu_read_unlock();
+
+	return id;
+#else
+	return 0;
+#endif
+}
+
+// 필터로 새 프로그램을 만들어 *slot 과 바꾸고 이전 프로그램을 해제, fprog 가 NULL 이면 떼어냄
+// fprog 는 호출하는 쪽이 유저에게서 복사해 온 구조체 (32 비트 프로세스의 구조체는 변환한 뒤), filter 는 유저 주소
+// 권한 검사는 호출하는 쪽에서 수행, 성공하면 0, 실패하면 -errno
+static inline int kb_filter_replace(struct bpf_prog __rcu **slot, struct sock_fprog *fprog, struct mutex *lock)
+{
+	struct bpf_prog *prog = NULL;
+	int error;
+
+	if (fprog != NULL)
+	{
+		error = bpf_prog_create_from_user(&prog, fprog, kb_filter_check, false);
+		if (error != 0)
+		{
+			return error;
+		}
+	}
+
+	mutex_lock(lock);
+	rcu_swap_protected(*slot, prog, lockdep_is_held(lock));
+	mutex_unlock(lock);
+
+	// 이전 프로그램을 실행 중인 복사가 끝난 뒤 해제
+	if (prog != NULL)
+	{
+		synchronize_rcu();
+		bpf_prog_destroy(prog);
+	}
+
+	return 0;
+}
+
+// 복사할 값을 필터에 통과시킴, 저장하면 0 (필터가 바꾼 값은 *item 에), 버리면 KB_FILTER_DROPPED
+// 필터가 없으면 음수 값만 -EINVAL 로 거부
+static inline int kb_filter_apply(struct bpf_prog __rcu **slot, int *item)
+{
+	struct kb_filter_data data;
+	struct bpf_prog *prog;
+	int result;
+
+	rcu_read_lock();
+
+	prog = rcu_dereference(*slot);
+	if (prog == NULL)
+	{
+		rcu_read_unlock();
+
+		return *item < 0 ? -EINVAL : 0;
+	}
+
+	data.Item = *item;
+	data.Pid = task_tgid_nr(current);
+	data.Cgroup = kb_filter_cgroup();
+	result = (int)BPF_PROG_RUN(prog, &data);
+
+	rcu_read_unlock();
+
+	if (result < 0)
+	{
+		return KB_FILTER_DROPPED;
+	}
+	*item = result;
+
+	return 0;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef _KBOARD_RING_H
+#define _KBOARD_RING_H
+
+// 클립보드 링 버퍼 연산
+// 커널(os_kboard.c)과 유저 공간 시뮬레이터(sim/)가 함께 사용하므로 커널 전용 헤더에 의존하지 않음
+// 동기화는 호출하는 쪽에서 담당
+
+#include "kboard_ring_generic.h"
+
+#define MAX_CLIP (5)
+#define INIT_VALUE (-1)
+
+// 우선순위 단계, 숫자가 클수록 먼저 붙여넣기 됨
+#define KB_PRIO_LEVELS (64)
+#define KB_PRIO_DEFAULT (0)
+
+// 클립보드 동작 방식 (kb_set_mode)
+// KB_MODE_OVERWRITE: 가득 찬 링 버퍼에 복사하면 실패하는 대신 가장 오래된 값을 덮어쓰고 Dropped 를 증가
+// KB_MODE_LIFO: 링 버퍼 대신 잠금 없는 스택(kboard_stack.h)을 사용, 가장 최근에 복사한 값을 먼저 붙여넣기
+//               우선순위와 덮어쓰기는 적용되지 않으며 링 버퍼에 남은 값은 FIFO 로 돌아오면 다시 붙여넣기 됨
+#define KB_MODE_OVERWRITE (1 << 0)
+#define KB_MODE_LIFO (1 << 1)
+#define KB_MODE_MASK (KB_MODE_OVERWRITE | KB_MODE_LIFO)
+
+// 붙여넣기를 기다리는 소비자를 깨우는 주기 (kb_set_coalesce, kb_dequeue_wait)
+// 우선순위마다 Count 개의 값이 들어오거나 깨우지 않은 첫 값이 들어온 뒤 Usecs 마이크로초가 지나면 한 번 깨움
+// 기본값은 Count 1, Usecs 0 으로 값이 들어올 때마다 깨움, Count 가 1 보다 크면 Usecs 가 있어야 함
+#define KB_COALESCE_USECS_MAX (1000000)
+
+// 추가 전용 로그 (kb_log_*)
+// 복사한 값마다 증가하는 순번을 붙이고, 등록한 소비자마다 자신의 읽기 위치를 가짐
+// 등록한 모든 소비자가 읽고 지나간 값의 자리만 재사용
+#define KB_LOG_SIZE (4096)			// 보관할 수 있는 값의 개수
+#define KB_LOG_CONSUMERS (16)		// 동시에 등록할 수 있는 소비자 수
+#define KB_LOG_BATCH_MAX (256)		// kb_log_read 한 번에 읽을 수 있는 최대 개수
+
+// 클립보드 통계 (kb_stat), 유저 공간과 공유하므로 필드는 끝에만 추가
+struct kb_stat
+{
+	long long Copied;	// 복사에 성공한 횟수
+	long long Pasted;	// 붙여넣기에 성공한 횟수
+	long long Dropped;	// 덮어쓰기로 인해 붙여넣기 되지 못하고 버려진 값의 개수
+	int Count;			// 모든 우선순위에 저장 된 값의 개수
+	int Mode;			// KB_MODE_* 조합
+	int Keys;			// 키 저장소(kb_put)에 저장 된 키의 개수
+	long long LogHead;	// 로그에 다음으로 추가될 값의 순번
+	long long LogTail;	// 로그에 보관 중인 가장 오래된 값의 순번
+	long long Expired;	// TTL 이 지나 붙여넣기 되지 못하고 제거된 값의 개수
+	long long Filtered;	// 필터(kb_set_filter)가 버린 값의 개수
+};
+
+// 제출, 완료 큐 (kb_queue_setup, kb_queue_enter)
+// kb_queue_setup 이 돌려준 fd 를 mmap 하면 맨 앞에 struct kb_queue_header, SqOffset 에 요청 배열, CqOffset 에 완료 배열이 있음
+// 유저는 요청을 SqTail 칸에 쓰고 SqTail 을 늘린 뒤 kb_queue_enter 로 알리고, 커널은 처리한 만큼 SqHead 를 늘리며 완료를 CqTail 칸에 씀
+// 유저는 완료를 읽은 만큼 CqHead 를 늘림, 각 칸의 위치는 (Head 또는 Tail) & (Entries - 1)
+#define KB_QUEUE_ENTRIES_MAX (4096)	// 제출 큐의 최대 칸 수, 2 의 거듭제곱으로 올림하고 완료 큐는 그 두 배
+
+#define KB_SQE_COPY (1)				// Item 을 Priority, Ttl 로 복사 (kb_enqueue_ttl)
+#define KB_SQE_PASTE (2)			// 붙여넣기 (kb_dequeue), 값은 완료의 Item
+
+#define KB_SQE_LINK (1 << 0)		// 다음 요청과 연결, 이 요청이 실패하면 연결이 끝날 때까지 다음 요청들은 실행하지 않고 취소
+
+#define KB_RESULT_CANCELED (-3)		// 연결된 앞 요청이 실패하여 취소됨, 그 밖의 Result 는 시스템 콜과 같음 (0 성공, -1 가득 참/비어 있음, -2 잘못된 요청)
+
+struct kb_sqe
+{
+	int Op;					// KB_SQE_COPY, KB_SQE_PASTE
+	int Flags;				// KB_SQE_LINK
+	int Item;
+	int Priority;
+	int Ttl;
+	int Reserved;
+	unsigned long long Tag;	// 완료에 그대로 돌려줌
+};
+
+struct kb_cqe
+{
+	unsigned long long Tag;
+	int Result;
+	int Item;				// 붙여넣기 한 값, 그 밖에는 INIT_VALUE
+};
+
+struct kb_queue_header
+{
+	unsigned int SqHead;	// 커널이 다음에 처리할 요청, 커널만 바꿈
+	unsigned int SqTail;	// 유저가 다음에 쓸 요청 칸, 유저만 바꿈
+	unsigned int CqHead;	// 유저가 다음에 읽을 완료, 유저만 바꿈
+	unsigned int CqTail;	// 커널이 다음에 쓸 완료 칸, 커널만 바꿈
+	unsigned int SqEntries;
+	unsigned int CqEntries;
+	unsigned int SqOffset;	// 매핑 시작에서 요청 배열까지의 바이트 수
+	unsigned int CqOffset;	// 매핑 시작에서 완료 배열까지의 바이트 수
+};
+
+// 링 버퍼의 한 칸, 값과 만료 시각
+struct kb_clip
+{
+	int Item;
+	unsigned long Expires;	// 값이 만료되는 시각 (jiffies), 0 이면 만료되지 않음
+};
+
+#define KB_CLIP_EMPTY ((struct kb_clip) { INIT_VALUE, 0 })
+
+// 우선순위 단계마다 하나씩 두는 링 버퍼, 우선순위 링 전체를 Lock 으로 보호하므로 잠금 없음
+KB_RING_DEFINE(kb_ring, struct kb_clip, MAX_CLIP, KB_CLIP_EMPTY, NONE)
+
+// 만료 시각이 지났는지 검사, 시각 값이 한 바퀴 돌아도 올바르게 비교
+static inline int kb_expired(unsigned long expires, unsigned long now)
+{
+	return expires != 0 && (long)(now - expires) >= 0;
+}
+
+// 만료된 값을 모두 제거하고 남은 값을 순서대로 앞으로 당김, 제거한 개수를 돌려줌
+static inline int kb_ring_expire(struct kb_ring *ring, unsigned long now)
+{
+	int offset;
+	int kept = 0;
+	struct kb_clip *clip;
+
+	for (offset = 0; offset < ring->Count; offset++)
+	{
+		clip = kb_ring_at(ring, offset);
+		if (kb_expired(clip->Expires, now))
+		{
+			continue;
+		}
+
+		*kb_ring_at(ring, kept) = *clip;
+		kept++;
+	}
+
+	// 당기고 남은 칸을 초기화
+	for (offset = kept; offset < ring->Count; offset++)
+	{
+		*kb_ring_at(ring, offset) = KB_CLIP_EMPTY;
+	}
+
+	offset = ring->Count - kept;
+	ring->Count = kept;
+
+	return offset;
+}
+
+// 링 버퍼에 남은 값 중 가장 빠른 만료 시각, 만료되는 값이 없으면 0
+static inline unsigned long kb_ring_next_expiry(struct kb_ring *ring)
+{
+	int offset;
+	unsigned long expires;
+	unsigned long earliest = 0;
+
+	for (offset = 0; offset < ring->Count; offset++)
+	{
+		expires = kb_ring_at(ring, offset)->Expires;
+		if (expires != 0 && (earliest == 0 || (long)(expires - earliest) < 0))
+		{
+			earliest = expires;
+		}
+	}
+
+	return earliest;
+}
+
+// 우선순위별 링 버퍼, 비어있지 않은 단계를 비트맵으로 관리해 가장 높은 단계를 O(1)에 찾음
+struct kb_prio_ring
+{
+	struct kb_ring Level[KB_PRIO_LEVELS];
+	unsigned long long NonEmpty;	// i 번째 비트가 1 이면 i 단계에 값이 있음
+	unsigned long long Expiring;	// i 번째 비트가 1 이면 i 단계에 만료 시각이 있는 값이 있을 수 있음, 만료 처리는 이 단계만 방문
+};
+
+// bits 에서 가장 낮은 1 비트의 위치를 돌려주고 그 비트를 지움
+static inline int kb_prio_next_level(unsigned long long *bits)
+{
+	int level = __builtin_ctzll(*bits);
+
+	*bits &= *bits - 1;
+	return level;
+}
+
+static inline void kb_prio_ring_init(struct kb_prio_ring *ring)
+{
+	int level;
+
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		kb_ring_init(&ring->Level[level]);
+	}
+	ring->NonEmpty = 0;
+	ring->Expiring = 0;
+}
+
+// 값이 있는 가장 높은 우선순위, 모두 비어 있으면 -1
+static inline int kb_prio_ring_highest(const struct kb_prio_ring *ring)
+{
+	if (ring->NonEmpty == 0)
+	{
+		return -1;
+	}
+
+	return 63 - __builtin_clzll(ring->NonEmpty);
+}
+
+static inline void kb_prio_ring_push_expires(struct kb_prio_ring *ring, int priority, int item, unsigned long expires)
+{
+	kb_ring_push(&ring->Level[priority], (struct kb_clip) { item, expires });
+	ring->NonEmpty |= 1ULL << priority;
+	if (expires != 0)
+	{
+		ring->Expiring |= 1ULL << priority;
+	}
+}
+
+static inline void kb_prio_ring_push(struct kb_prio_ring *ring, int priority, int item)
+{
+	kb_prio_ring_push_expires(ring, priority, item, 0);
+}
+
+static inline void kb_prio_ring_pop(struct kb_prio_ring *ring, int priority)
+{
+	kb_ring_pop(&ring->Level[priority]);
+	if (kb_ring_is_empty(&ring->Level[priority]))
+	{
+		ring->NonEmpty &= ~(1ULL << priority);
+		ring->Expiring &= ~(1ULL << priority);
+	}
+}
+
+// 만료 시각이 있는 값을 가진 우선순위에서만 만료된 값을 제거, 제거한 개수를 돌려줌
+static inline int kb_prio_ring_expire(struct kb_prio_ring *ring, unsigned long now)
+{
+	int level;
+	int removed = 0;
+	unsigned long long pending = ring->NonEmpty & ring->Expiring;
+
+	while (pending != 0)
+	{
+		level = kb_prio_next_level(&pending);
+		removed += kb_ring_expire(&ring->Level[level], now);
+		if (kb_ring_is_empty(&ring->Level[level]))
+		{
+			ring->NonEmpty &= ~(1ULL << level);
+		}
+		if (kb_ring_next_expiry(&ring->Level[level]) == 0)
+		{
+			ring->Expiring &= ~(1ULL << level);
+		}
+	}
+
+	return removed;
+}
+
+// 남아 있는 값 중 가장 빠른 만료 시각, 만료되는 값이 없으면 0
+static inline unsigned long kb_prio_ring_next_expiry(struct kb_prio_ring *ring)
+{
+	unsigned long expires;
+	unsigned long earliest = 0;
+	unsigned long long pending = ring->NonEmpty & ring->Expiring;
+
+	while (pending != 0)
+	{
+		expires = kb_ring_next_expiry(&ring->Level[kb_prio_next_level(&pending)]);
+		if (expires != 0 && (earliest == 0 || (long)(expires - earliest) < 0))
+		{
+			earliest = expires;
+		}
+	}
+
+	return earliest;
+}
+
+#endif
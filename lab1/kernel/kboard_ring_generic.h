@@ -0,0 +1,187 @@
+#ifndef _KBOARD_RING_GENERIC_H
+#define _KBOARD_RING_GENERIC_H
+
+// 컴파일 시간에 원소 타입, 용량, 동기화 정책을 정하는 링 버퍼
+// KB_RING_DEFINE(name, type, capacity, empty, sync) 는 struct name 과 name_* 인라인 함수들을 만듦
+//   type     : 원소 타입
+//   capacity : 상수 용량, 2 의 거듭제곱이면 % 대신 마스크로 인덱스를 감음
+//   empty    : 비어 있는 칸의 값
+//   sync     : NONE  - 잠금 없음, 호출하는 쪽에서 동기화 (os_kboard.c 의 Lock, KboardModule.c 의 세마포어 솔루션)
+//              두 프론트엔드 모두 여러 링 또는 링 밖의 상태를 한 잠금으로 보호하므로 현재는 NONE 만 정의
+// 모든 인스턴스는 별도의 함수로 만들어지므로 간접 호출 없이 컴파일러가 상수 용량에 맞게 최적화함
+// 커널, 유저 공간 시뮬레이터(sim/)가 함께 사용하므로 커널 전용 헤더에 의존하지 않음
+
+// 동기화 정책
+#define KB_RING_SYNC_NONE_TYPE char
+#define KB_RING_SYNC_NONE_INIT(lock) ((void)(lock))
+
+#define KB_RING_DEFINE(name, type, capacity, empty, sync)											\
+struct name																							\
+{																									\
+	type Ring[capacity];																			\
+	int Count;			/* 저장 된 값의 개수 */														\
+	int CurrentIndex;	/* 꺼낼 값의 인덱스 */														\
+	KB_RING_SYNC_##sync##_TYPE Lock;																\
+};																									\
+																									\
+/* 인덱스를 용량 안으로 감음, 용량이 2 의 거듭제곱이면 컴파일러가 마스크만 남김 */					\
+static inline int name##_slot(unsigned int index)													\
+{																									\
+	if (((capacity) & ((capacity) - 1)) == 0)														\
+	{																								\
+		return index & ((capacity) - 1);															\
+	}																								\
+																									\
+	return index % (capacity);																		\
+}																									\
+																									\
+static inline void name##_init(struct name *ring)													\
+{																									\
+	int index;																						\
+																									\
+	for (index = 0; index < (capacity); index++)													\
+	{																								\
+		ring->Ring[index] = (empty);																\
+	}																								\
+	ring->Count = 0;																				\
+	ring->CurrentIndex = 0;																			\
+	KB_RING_SYNC_##sync##_INIT(&ring->Lock);														\
+}																									\
+																									\
+static inline int name##_is_full(const struct name *ring)											\
+{																									\
+	return ring->Count >= (capacity);																\
+}																									\
+																									\
+static inline int name##_is_empty(const struct name *ring)											\
+{																									\
+	return ring->Count <= 0;																		\
+}																									\
+																									\
+/* 앞에서 offset 번째 값의 위치 */																	\
+static inline type *name##_at(struct name *ring, int offset)										\
+{																									\
+	return &ring->Ring[name##_slot(ring->CurrentIndex + offset)];									\
+}																									\
+																									\
+/* 다음에 꺼낼 값의 위치 */																			\
+static inline type *name##_front(struct name *ring)													\
+{																									\
+	return &ring->Ring[ring->CurrentIndex];															\
+}																									\
+																									\
+/* 끝에 값을 저장하고 Count 를 증가, 가득 찼는지는 호출하는 쪽에서 검사 */							\
+static inline void name##_push(struct name *ring, type item)										\
+{																									\
+	*name##_at(ring, ring->Count) = item;															\
+	ring->Count++;																					\
+}																									\
+																									\
+/* 꺼낸 칸을 비우고 CurrentIndex 를 다음 칸으로 이동, 비었는지는 호출하는 쪽에서 검사 */				\
+static inline void name##_pop(struct name *ring)													\
+{																									\
+	ring->Ring[ring->CurrentIndex] = (empty);														\
+	ring->Count--;																					\
+	ring->CurrentIndex = name##_slot(ring->CurrentIndex + 1);										\
+}
+
+
+// 실행 중에 용량을 정하는 링 버퍼
+// KB_RING_DEFINE_DYNAMIC(name, type, empty, sync) 는 용량을 링 안의 Capacity 로 가지고 원소 배열이 구조체 끝에 붙는 struct name 을 만듦
+// 메모리는 호출하는 쪽에서 name_size(capacity) 만큼 할당하고 name_init(ring, capacity) 로 초기화
+// 용량은 그대로 사용하며 2 의 거듭제곱이면 저장해 둔 Mask 로, 아니면 % 로 인덱스를 감음
+// 용량을 바꿀 때는 새 링을 할당해 name_copy 로 값을 순서대로 옮긴 뒤 포인터를 바꿈
+#define KB_RING_DEFINE_DYNAMIC(name, type, empty, sync)												\
+struct name																							\
+{																									\
+	int Capacity;		/* 칸의 개수 */																\
+	unsigned int Mask;	/* Capacity 가 2 의 거듭제곱이면 Capacity - 1, 아니면 0 */					\
+	int Count;			/* 저장 된 값의 개수 */														\
+	int CurrentIndex;	/* 꺼낼 값의 인덱스 */														\
+	KB_RING_SYNC_##sync##_TYPE Lock;																\
+	type Ring[];																					\
+};																									\
+																									\
+static inline size_t name##_size(int capacity)														\
+{																									\
+	return sizeof(struct name) + sizeof(type) * (size_t)capacity;									\
+}																									\
+																									\
+/* 인덱스를 용량 안으로 감음 */																	\
+static inline int name##_slot(const struct name *ring, unsigned int index)							\
+{																									\
+	if (ring->Mask != 0)																			\
+	{																								\
+		return index & ring->Mask;																	\
+	}																								\
+																									\
+	return index % (unsigned int)ring->Capacity;													\
+}																									\
+																									\
+static inline void name##_init(struct name *ring, int capacity)										\
+{																									\
+	int index;																						\
+																									\
+	for (index = 0; index < capacity; index++)														\
+	{																								\
+		ring->Ring[index] = (empty);																\
+	}																								\
+	ring->Capacity = capacity;																		\
+	ring->Mask = (capacity & (capacity - 1)) == 0 ? capacity - 1 : 0;								\
+	ring->Count = 0;																				\
+	ring->CurrentIndex = 0;																			\
+	KB_RING_SYNC_##sync##_INIT(&ring->Lock);														\
+}																									\
+																									\
+static inline int name##_is_full(const struct name *ring)											\
+{																									\
+	return ring->Count >= ring->Capacity;															\
+}																									\
+																									\
+static inline int name##_is_empty(const struct name *ring)											\
+{																									\
+	return ring->Count <= 0;																		\
+}																									\
+																									\
+/* 앞에서 offset 번째 값의 위치 */																	\
+static inline type *name##_at(struct name *ring, int offset)										\
+{																									\
+	return &ring->Ring[name##_slot(ring, ring->CurrentIndex + offset)];								\
+}																									\
+																									\
+/* 다음에 꺼낼 값의 위치 */																			\
+static inline type *name##_front(struct name *ring)													\
+{																									\
+	return &ring->Ring[ring->CurrentIndex];															\
+}																									\
+																									\
+/* 끝에 값을 저장하고 Count 를 증가, 가득 찼는지는 호출하는 쪽에서 검사 */							\
+static inline void name##_push(struct name *ring, type item)										\
+{																									\
+	*name##_at(ring, ring->Count) = item;															\
+	ring->Count++;																					\
+}																									\
+																									\
+/* 꺼낸 칸을 비우고 CurrentIndex 를 다음 칸으로 이동, 비었는지는 호출하는 쪽에서 검사 */				\
+static inline void name##_pop(struct name *ring)													\
+{																									\
+	ring->Ring[ring->CurrentIndex] = (empty);														\
+	ring->Count--;																					\
+	ring->CurrentIndex = name##_slot(ring, ring->CurrentIndex + 1);									\
+}																									\
+																									\
+/* 초기화한 빈 링 to 에 from 의 값을 순서대로 0 번 칸부터 옮김, from 은 바꾸지 않음 */				\
+/* to 의 용량이 모자라면 앞에서부터 들어가는 만큼만 옮기고 옮긴 개수를 돌려줌 */						\
+static inline int name##_copy(struct name *to, struct name *from)									\
+{																									\
+	int offset;																						\
+																									\
+	for (offset = 0; offset < from->Count && !name##_is_full(to); offset++)						\
+	{																								\
+		name##_push(to, *name##_at(from, offset));													\
+	}																								\
+																									\
+	return offset;																					\
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef _KBOARD_STACK_H
+#define _KBOARD_STACK_H
+
+// 잠금 없는 클립보드 스택 (Treiber stack)
+// 미리 할당한 노드 배열 위에 사용 중인 노드의 스택(Head)과 빈 노드의 스택(Free)을 둠
+// Head, Free 는 64 비트 값으로 하위 32 비트가 노드 인덱스, 상위 32 비트가 변경할 때마다 증가하는 tag
+// 꺼낸 노드가 다시 같은 자리로 돌아와도 tag 가 달라지므로 cmpxchg64 가 실패하여 ABA 문제를 막음
+// 커널(os_kboard.c)과 유저 공간 시뮬레이터(sim/)가 함께 사용하므로
+// READ_ONCE, WRITE_ONCE, cmpxchg64 는 포함하는 쪽에서 제공
+
+#define KB_STACK_SIZE (256)
+#define KB_STACK_NIL (0xffffffffU)
+
+struct kb_stack_node
+{
+	int Item;
+	unsigned int Next;	// 아래 노드의 인덱스, 없으면 KB_STACK_NIL
+};
+
+struct kb_stack
+{
+	unsigned long long Head;	// 붙여넣기 할 값이 있는 노드의 스택
+	unsigned long long Free;	// 비어 있는 노드의 스택
+	struct kb_stack_node Node[KB_STACK_SIZE];
+};
+
+static inline unsigned int kb_stack_index(unsigned long long top)
+{
+	return (unsigned int)top;
+}
+
+static inline unsigned long long kb_stack_make(unsigned long long top, unsigned int index)
+{
+	return (((top >> 32) + 1) << 32) | index;
+}
+
+// top 이 가리키는 스택의 맨 위 노드를 꺼냄, 비어 있으면 KB_STACK_NIL
+// 꺼내는 사이에 다른 쓰레드가 노드를 재사용해도 노드 배열은 해제되지 않으므로 Next 를 읽는 것은 안전하며
+// 그 값이 낡았다면 tag 가 바뀌어 cmpxchg64 가 실패함
+static inline unsigned int kb_stack_take(struct kb_stack *stack, unsigned long long *top)
+{
+	unsigned long long old;
+	unsigned int index;
+
+	do
+	{
+		old = READ_ONCE(*top);
+		index = kb_stack_index(old);
+		if (index == KB_STACK_NIL)
+		{
+			return KB_STACK_NIL;
+		}
+	} while (cmpxchg64(top, old, kb_stack_make(old, READ_ONCE(stack->Node[index].Next))) != old);
+
+	return index;
+}
+
+// top 이 가리키는 스택의 맨 위에 노드를 올림
+static inline void kb_stack_give(struct kb_stack *stack, unsigned long long *top, unsigned int index)
+{
+	unsigned long long old;
+
+	do
+	{
+		old = READ_ONCE(*top);
+		WRITE_ONCE(stack->Node[index].Next, kb_stack_index(old));
+	} while (cmpxchg64(top, old, kb_stack_make(old, index)) != old);
+}
+
+// 모든 노드를 빈 노드의 스택에 넣음, 다른 쓰레드가 사용하지 않을 때만 호출
+static inline void kb_stack_init(struct kb_stack *stack)
+{
+	unsigned int index;
+
+	for (index = 0; index < KB_STACK_SIZE; index++)
+	{
+		stack->Node[index].Item = INIT_VALUE;
+		stack->Node[index].Next = index + 1 < KB_STACK_SIZE ? index + 1 : KB_STACK_NIL;
+	}
+	stack->Head = KB_STACK_NIL;
+	stack->Free = 0;
+}
+
+// 스택에 값을 넣음, 빈 노드가 없으면 -1
+static inline int kb_stack_push(struct kb_stack *stack, int item)
+{
+	unsigned int index;
+
+	index = kb_stack_take(stack, &stack->Free);
+	if (index == KB_STACK_NIL)
+	{
+		return -1;
+	}
+
+	// 노드를 Head 에 올리는 cmpxchg64 가 Item 저장 이후에 보이도록 보장
+	stack->Node[index].Item = item;
+	kb_stack_give(stack, &stack->Head, index);
+
+	return 0;
+}
+
+// 가장 최근에 넣은 값의 노드를 Head 에서 떼어 냄, 비어 있으면 KB_STACK_NIL
+// 떼어 낸 노드는 다른 쓰레드가 사용할 수 없으므로 값을 넘겨준 뒤 kb_stack_commit, 넘겨주지 못하면 kb_stack_cancel
+static inline unsigned int kb_stack_reserve(struct kb_stack *stack)
+{
+	return kb_stack_take(stack, &stack->Head);
+}
+
+// 떼어 낸 노드를 비우고 빈 노드의 스택에 돌려줌
+static inline void kb_stack_commit(struct kb_stack *stack, unsigned int index)
+{
+	stack->Node[index].Item = INIT_VALUE;
+	kb_stack_give(stack, &stack->Free, index);
+}
+
+// 떼어 낸 노드를 값과 함께 다시 Head 에 올림, 빈 노드가 필요 없으므로 실패하지 않음
+static inline void kb_stack_cancel(struct kb_stack *stack, unsigned int index)
+{
+	kb_stack_give(stack, &stack->Head, index);
+}
+
+// 가장 최근에 넣은 값을 꺼냄, 비어 있으면 -1
+static inline int kb_stack_pop(struct kb_stack *stack, int *item)
+{
+	unsigned int index;
+
+	index = kb_stack_reserve(stack);
+	if (index == KB_STACK_NIL)
+	{
+		return -1;
+	}
+
+	*item = stack->Node[index].Item;
+	kb_stack_commit(stack, index);
+
+	return 0;
+}
+
+// 스택이 비어 있는지 잠금 없이 검사, 검사한 뒤에 바뀔 수 있으므로 기다릴지 정하는 데만 사용
+static inline int kb_stack_is_empty(struct kb_stack *stack)
+{
+	return kb_stack_index(READ_ONCE(stack->Head)) == KB_STACK_NIL;
+}
+
+#endif
@@ -1,21 +1,810 @@
+#include <linux/anon_inodes.h>
+#include <linux/capability.h>
+#include <linux/atomic.h>
+#include <linux/cache.h>
+#include <linux/compiler.h>
+#include <linux/file.h>
+#include <linux/fs.h>
+#include <linux/hrtimer.h>
+#include <linux/init.h>
+#include <linux/jiffies.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/rcupdate.h>
+#include <linux/rhashtable.h>
+#include <linux/slab.h>
 #include <linux/spinlock.h>
+#include <linux/string.h>
 #include <linux/syscalls.h>
+#include <linux/timer.h>
 #include <linux/printk.h>
 #include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+#include <linux/wait.h>
 
-#define MAX_CLIP (5)
-#define INIT_VALUE (-1)
+#include "kboard_filter.h"
+#include "kboard_ring.h"
+#include "kboard_stack.h"
 
 spinlock_t Lock;
 
-int Ring[MAX_CLIP];		// RingBuffer
-int Count = 0;			// 저장 된 값의 개수
-int CurrentIndex = 0;	// 붙여넣기 할 값의 인덱스
+struct kb_prio_ring Clipboard;
 
-// 매개변수로 받은 값을 링 버퍼에 넣음
+// KB_MODE_* 조합과 통계, Lock 으로 보호
+int Mode;
+struct kb_stat Stat;
+
+// 만료된 값을 제거하는 타이머, 남은 값 중 가장 빠른 만료 시각에 맞춰 동작
+// 타이머가 softirq 에서 Lock 을 잡으므로 시스템 콜에서는 spin_lock_bh 를 사용
+static void kb_expire_timer(struct timer_list *timer);
+static DEFINE_TIMER(ExpiryTimer, kb_expire_timer);
+
+static void kb_expire_timer(struct timer_list *timer)
+{
+	int expired;
+	unsigned long next;
+
+	spin_lock(&Lock);
+
+	expired = kb_prio_ring_expire(&Clipboard, jiffies);
+	Stat.Expired += expired;
+
+	// 아직 만료되지 않은 값이 남아 있으면 다시 예약
+	next = kb_prio_ring_next_expiry(&Clipboard);
+	if (next != 0)
+	{
+		mod_timer(&ExpiryTimer, next);
+	}
+
+	spin_unlock(&Lock);
+
+	printk(KERN_DEBUG "KBOARD: Expired '%d' items, next: '%lu'\n", expired, next);
+}
+
+// 만료 시각이 있는 값을 넣었으면 타이머가 그 시각보다 늦지 않게 동작하도록 예약, Lock 을 잡은 상태에서 호출
+static void kb_expire_arm(unsigned long expires)
+{
+	if (expires == 0)
+	{
+		return;
+	}
+
+	if (!timer_pending(&ExpiryTimer) || time_before(expires, ExpiryTimer.expires))
+	{
+		mod_timer(&ExpiryTimer, expires);
+	}
+}
+
+// KB_MODE_LIFO 에서 사용하는 스택, Lock 없이 접근하므로 통계도 atomic 으로 관리
+struct kb_stack Stack;
+atomic_long_t StackCopied;
+atomic_long_t StackPasted;
+
+// 잠금 없는 스택에 값을 넣음
+static long kb_stack_enqueue(int item)
+{
+	if (kb_stack_push(&Stack, item) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Stack is full\n");
+
+		return -1;
+	}
+	atomic_long_inc(&StackCopied);
+
+	return 0;
+}
+
+// 잠금 없는 스택에서 가장 최근의 값을 꺼내 유저에게 넣어줌
+// 복사가 끝날 때까지 노드를 떼어 둔 채로 두므로 실패하면 그 노드를 그대로 돌려놓아 다른 생산자가 스택을 채워도 값을 잃지 않음
+static long kb_stack_dequeue(int *user_buf)
+{
+	unsigned int index;
+	int item;
+
+	index = kb_stack_reserve(&Stack);
+	if (index == KB_STACK_NIL)
+	{
+		printk(KERN_DEBUG "KBOARD: Stack is empty\n");
+
+		return -1;
+	}
+	item = Stack.Node[index].Item;
+
+	if (copy_to_user(user_buf, &item, sizeof(item)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, BufferValue: '%d', UserAddress: '0x%p'\n", item, user_buf);
+		kb_stack_cancel(&Stack, index);
+
+		return -2;
+	}
+	kb_stack_commit(&Stack, index);
+	atomic_long_inc(&StackPasted);
+
+	return 0;
+}
+
+// 붙여넣기를 기다리는 소비자를 깨우는 주기, 우선순위마다 하나씩 두고 Lock 으로 보호
+// 값마다 깨우면 값마다 문맥 교환이 일어나므로 Count 개가 모이거나 첫 값 뒤로 Usecs 가 지날 때까지 미룸
+struct kb_coalesce
+{
+	int Count;				// 이만큼 모이면 바로 깨움
+	unsigned int Usecs;		// 깨우지 않은 첫 값이 들어온 뒤 이만큼 지나면 깨움, 0 이면 시간으로는 깨우지 않음
+	int Pending;			// 들어왔지만 아직 깨우지 않은 값의 개수
+	struct hrtimer Timer;	// softirq 에서 동작하여 만료 타이머처럼 Lock 을 잡음
+};
+
+static struct kb_coalesce Coalesce[KB_PRIO_LEVELS];
+static DECLARE_WAIT_QUEUE_HEAD(PasteWait);
+
+static enum hrtimer_restart kb_coalesce_timer(struct hrtimer *timer)
+{
+	struct kb_coalesce *coalesce = container_of(timer, struct kb_coalesce, Timer);
+	bool wake;
+
+	spin_lock(&Lock);
+	wake = coalesce->Pending > 0;
+	coalesce->Pending = 0;
+	spin_unlock(&Lock);
+
+	if (wake)
+	{
+		wake_up_interruptible(&PasteWait);
+	}
+
+	return HRTIMER_NORESTART;
+}
+
+// 값마다 깨우도록 되돌림, 타이머는 멈춘 상태에서 호출
+static void kb_coalesce_reset(void)
+{
+	int level;
+
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		Coalesce[level].Count = 1;
+		Coalesce[level].Usecs = 0;
+		Coalesce[level].Pending = 0;
+	}
+}
+
+// 부팅 중에 우선순위마다 타이머를 만듦
+static int __init kb_coalesce_init(void)
+{
+	int level;
+
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		hrtimer_init(&Coalesce[level].Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL_SOFT);
+		Coalesce[level].Timer.function = kb_coalesce_timer;
+	}
+	kb_coalesce_reset();
+
+	return 0;
+}
+subsys_initcall(kb_coalesce_init);
+
+// 해당 우선순위에 값이 들어왔음을 기록하고 지금 깨워야 하면 true, Lock 을 잡은 상태에서 호출
+// 깨우기는 Lock 을 놓은 뒤 호출하는 쪽에서 함
+static bool kb_coalesce_notify(int priority)
+{
+	struct kb_coalesce *coalesce = &Coalesce[priority];
+
+	coalesce->Pending++;
+	if (coalesce->Pending >= coalesce->Count)
+	{
+		// 타이머가 이미 Lock 을 기다리고 있으면 취소되지 않지만 Pending 이 0 이라 다시 깨우지 않음
+		coalesce->Pending = 0;
+		hrtimer_try_to_cancel(&coalesce->Timer);
+
+		return true;
+	}
+
+	if (coalesce->Pending == 1 && coalesce->Usecs > 0)
+	{
+		hrtimer_start(&coalesce->Timer, ns_to_ktime((u64)coalesce->Usecs * NSEC_PER_USEC), HRTIMER_MODE_REL_SOFT);
+	}
+
+	return false;
+}
+
+// 붙여넣기 할 값이 있는지 잠금 없이 검사
+static bool kb_readable(void)
+{
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		return !kb_stack_is_empty(&Stack);
+	}
+
+	return READ_ONCE(Clipboard.NonEmpty) != 0;
+}
+
+// 키 저장소의 항목
+// 조회는 RCU 로 잠금 없이, 추가와 삭제는 rhashtable 의 버킷별 잠금으로 처리하며
+// 키 개수에 맞춰 테이블이 자동으로 늘어나고 줄어듦
+struct kb_entry
+{
+	int Key;
+	int Value;
+	struct rhash_head Node;
+	struct rcu_head Rcu;
+};
+
+static const struct rhashtable_params KeyTableParams =
+{
+	.key_len = sizeof(int),
+	.key_offset = offsetof(struct kb_entry, Key),
+	.head_offset = offsetof(struct kb_entry, Node),
+	.automatic_shrinking = true,
+};
+
+struct rhashtable KeyTable;
+
+// 부팅 중에 키 저장소를 만듦
+static int __init kb_key_table_init(void)
+{
+	return rhashtable_init(&KeyTable, &KeyTableParams);
+}
+subsys_initcall(kb_key_table_init);
+
+// 키 저장소의 모든 항목을 삭제, 동시에 kb_put, kb_get 이 호출되어도 안전함
+static void kb_key_table_clear(void)
+{
+	struct rhashtable_iter iter;
+	struct kb_entry *entry;
+
+	rhashtable_walk_enter(&KeyTable, &iter);
+	rhashtable_walk_start(&iter);
+
+	while ((entry = rhashtable_walk_next(&iter)) != NULL)
+	{
+		// 테이블 크기가 바뀌는 중이면 다시 순회
+		if (IS_ERR(entry))
+		{
+			continue;
+		}
+
+		if (rhashtable_remove_fast(&KeyTable, &entry->Node, KeyTableParams) == 0)
+		{
+			kfree_rcu(entry, Rcu);
+		}
+	}
+
+	rhashtable_walk_stop(&iter);
+	rhashtable_walk_exit(&iter);
+}
+
+// 추가 전용 로그, LogLock 으로 보호
+// 순번 seq 의 값은 Log[seq % KB_LOG_SIZE] 에 있고 LogTail <= seq < LogHead 인 값만 유효함
+struct kb_log_consumer
+{
+	bool Used;
+	unsigned long long Offset;	// 다음에 읽을 순번
+};
+
+DEFINE_SPINLOCK(LogLock);
+int Log[KB_LOG_SIZE];
+unsigned long long LogHead;
+unsigned long long LogTail;
+struct kb_log_consumer LogConsumer[KB_LOG_CONSUMERS];
+
+// 모든 소비자가 지나간 자리를 회수, 소비자가 없으면 모두 회수
+// 로그가 가득 찼을 때만 호출하여 추가 경로에서 소비자를 순회하지 않음
+static void kb_log_reclaim(void)
+{
+	int id;
+	unsigned long long tail = LogHead;
+
+	for (id = 0; id < KB_LOG_CONSUMERS; id++)
+	{
+		if (LogConsumer[id].Used && LogConsumer[id].Offset < tail)
+		{
+			tail = LogConsumer[id].Offset;
+		}
+	}
+	LogTail = tail;
+}
+
+// 로그를 초기화, LogLock 을 잡은 상태에서 호출
+static void kb_log_init(void)
+{
+	int index;
+
+	for (index = 0; index < KB_LOG_SIZE; index++)
+	{
+		Log[index] = INIT_VALUE;
+	}
+	memset(LogConsumer, 0, sizeof(LogConsumer));
+	LogHead = 0;
+	LogTail = 0;
+}
+
+// 복사 경로의 BPF 필터, 복사는 RCU 안에서 실행하고 바꾸는 쪽은 FilterLock 으로 직렬화
+static struct bpf_prog __rcu *Filter;
+static DEFINE_MUTEX(FilterLock);
+
+// 매개변수로 받은 값을 해당 우선순위의 링 버퍼에 넣음, ttl 밀리초가 지나면 붙여넣기 되지 않고 제거됨 (0 이면 만료되지 않음)
+// 필터가 버린 값은 넣지 않고 성공으로 처리
+long do_sys_kb_enqueue_ttl(int item, int priority, int ttl)
+{
+	unsigned long expires = 0;
+	long result;
+	bool wake;
+	int filtered;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_enqueue_ttl() Called, item: '%d', priority: '%d', ttl: '%d'\n", item, priority, ttl);
+
+	// 우선순위가 범위 안에 있는지 검사
+	if (priority < 0 || priority >= KB_PRIO_LEVELS)
+	{
+		printk(KERN_DEBUG "KBOARD: priority out of range, priority: '%d'\n", priority);
+
+		return -2;
+	}
+
+	// TTL 이 음수인지 검사
+	if (ttl < 0)
+	{
+		printk(KERN_DEBUG "KBOARD: ttl cannot be negative value, ttl: '%d'\n", ttl);
+
+		return -2;
+	}
+
+	// 필터가 있으면 필터가 값을 받거나 바꾸거나 버리고, 없으면 음수 값인지 검사
+	filtered = kb_filter_apply(&Filter, &item);
+	if (filtered < 0)
+	{
+		printk(KERN_DEBUG "KBOARD: item cannot be negative value, item: '%d'\n", item);
+
+		return -2;
+	}
+
+	if (filtered == KB_FILTER_DROPPED)
+	{
+		spin_lock_bh(&Lock);
+		Stat.Filtered++;
+		spin_unlock_bh(&Lock);
+
+		return 0;
+	}
+
+	// 스택 모드에서는 Lock 없이 처리, TTL 과 깨우는 주기는 적용되지 않음
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		result = kb_stack_enqueue(item);
+		if (result == 0)
+		{
+			wake_up_interruptible(&PasteWait);
+		}
+
+		return result;
+	}
+
+	// 만료 시각 0 은 만료되지 않음을 뜻하므로 피함
+	if (ttl > 0)
+	{
+		expires = jiffies + msecs_to_jiffies(ttl);
+		if (expires == 0)
+		{
+			expires = 1;
+		}
+	}
+
+	spin_lock_bh(&Lock);
+
+	// 해당 우선순위의 링 버퍼가 가득 찼는지 검사
+	if (kb_ring_is_full(&Clipboard.Level[priority]))
+	{
+		// 덮어쓰기 모드가 아니면 실패
+		if ((Mode & KB_MODE_OVERWRITE) == 0)
+		{
+			printk(KERN_DEBUG "KBOARD: Buffer is full, Count: '%d', priority: '%d'\n", Clipboard.Level[priority].Count, priority);
+			spin_unlock_bh(&Lock);
+
+			return -1;
+		}
+
+		// 가장 오래된 값을 버리고 그 자리를 사용
+		kb_prio_ring_pop(&Clipboard, priority);
+		Stat.Dropped++;
+	}
+
+	// 링 버퍼에 값을 저장하고 Count를 증가
+	kb_prio_ring_push_expires(&Clipboard, priority, item, expires);
+	kb_expire_arm(expires);
+	Stat.Copied++;
+	wake = kb_coalesce_notify(priority);
+
+	spin_unlock_bh(&Lock);
+
+	if (wake)
+	{
+		wake_up_interruptible(&PasteWait);
+	}
+
+    return 0;
+}
+
+// 매개변수로 받은 값을 해당 우선순위의 링 버퍼에 넣음
+long do_sys_kb_enqueue_prio(int item, int priority)
+{
+	return do_sys_kb_enqueue_ttl(item, priority, 0);
+}
+
+// 매개변수로 받은 값을 기본 우선순위의 링 버퍼에 넣음
 long do_sys_kb_enqueue(int item)
 {
-    printk(KERN_DEBUG "KBOARD: do_sys_kb_enqueue() Called, item: '%d'\n", item);
+	return do_sys_kb_enqueue_prio(item, KB_PRIO_DEFAULT);
+}
+
+// 맨 앞의 값이 만료되었으면 타이머를 기다리지 않고 건너뛰며 값이 있는 가장 높은 우선순위를 찾음
+// Lock 을 잡은 상태에서 호출, 모든 우선순위의 링 버퍼가 비어 있으면 -1
+static int kb_dequeue_front(void)
+{
+	int priority;
+
+	while ((priority = kb_prio_ring_highest(&Clipboard)) >= 0 &&
+		kb_expired(kb_ring_front(&Clipboard.Level[priority])->Expires, jiffies))
+	{
+		kb_prio_ring_pop(&Clipboard, priority);
+		Stat.Expired++;
+	}
+
+	return priority;
+}
+
+// 매개변수로 받은 주소에 가장 높은 우선순위의 링 버퍼에서 가장 오래된 값을 넣어줌
+long do_sys_kb_dequeue(int *user_buf)
+{
+	int priority;
+	struct kb_ring *ring;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_dequeue() Called, address: '0x%p'\n", user_buf);
+
+	// 스택 모드에서는 Lock 없이 처리
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		return kb_stack_dequeue(user_buf);
+	}
+
+	spin_lock_bh(&Lock);
+
+	priority = kb_dequeue_front();
+
+	// 모든 우선순위의 링 버퍼가 비어있는지 검사
+	if (priority < 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Buffer is empty\n");
+		spin_unlock_bh(&Lock);
+
+		return -1;
+	}
+	ring = &Clipboard.Level[priority];
+
+	// 링 버퍼의 값을 유저에게 복사해 주고 예외처리
+	if (copy_to_user(user_buf, &kb_ring_front(ring)->Item, sizeof(kb_ring_front(ring)->Item)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, Count: '%d', CurrentIndex: '%d', BufferValue: '%d', UserAddress: '0x%p'\n", ring->Count, ring->CurrentIndex, kb_ring_front(ring)->Item, user_buf);
+		spin_unlock_bh(&Lock);
+
+		return -2;
+	}
+
+	// 붙여넣기가 끝난 값을 초기화하고 CurrentIndex를 다음 칸으로 이동
+	kb_prio_ring_pop(&Clipboard, priority);
+	Stat.Pasted++;
+
+	spin_unlock_bh(&Lock);
+
+    return 0;
+}
+
+// 붙여넣기 할 값이 생길 때까지 기다린 뒤 매개변수로 받은 주소에 값을 넣어줌
+// 잠든 뒤에는 kb_set_coalesce 로 정한 주기에 맞춰서만 깨어나고, 깨어난 뒤에는 남은 값을 잠들지 않고 이어서 붙여넣기 할 수 있음
+long do_sys_kb_dequeue_wait(int *user_buf)
+{
+	long result;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_dequeue_wait() Called, address: '0x%p'\n", user_buf);
+
+	for (;;)
+	{
+		if (wait_event_interruptible(PasteWait, kb_readable()) != 0)
+		{
+			return -ERESTARTSYS;
+		}
+
+		// 다른 소비자가 먼저 가져갔거나 값이 만료되었으면 다시 기다림
+		result = do_sys_kb_dequeue(user_buf);
+		if (result != -1)
+		{
+			return result;
+		}
+	}
+}
+
+// 해당 우선순위의 값을 기다리는 소비자를 count 개마다, 또는 첫 값 뒤로 usecs 마이크로초마다 깨움
+long do_sys_kb_set_coalesce(int priority, int count, int usecs)
+{
+	struct kb_coalesce *coalesce;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_set_coalesce() Called, priority: '%d', count: '%d', usecs: '%d'\n", priority, count, usecs);
+
+	// 우선순위가 범위 안에 있는지 검사
+	if (priority < 0 || priority >= KB_PRIO_LEVELS)
+	{
+		printk(KERN_DEBUG "KBOARD: priority out of range, priority: '%d'\n", priority);
+
+		return -2;
+	}
+
+	// 링 버퍼보다 많이 모을 수는 없고, 여러 개를 모으면 시간 제한이 있어야 값이 무한히 기다리지 않음
+	if (count < 1 || count > MAX_CLIP || usecs < 0 || usecs > KB_COALESCE_USECS_MAX || (count > 1 && usecs == 0))
+	{
+		printk(KERN_DEBUG "KBOARD: coalesce out of range, count: '%d', usecs: '%d'\n", count, usecs);
+
+		return -2;
+	}
+	coalesce = &Coalesce[priority];
+
+	// 복사가 이전 설정으로 타이머를 다시 예약하지 않도록 Lock 안에서 타이머를 멈추고 설정을 바꿈
+	// 타이머가 이미 Lock 을 기다리고 있으면 취소되지 않지만 Pending 이 0 이라 아무것도 하지 않음, 모인 값은 아래에서 깨움
+	spin_lock_bh(&Lock);
+	hrtimer_try_to_cancel(&coalesce->Timer);
+	coalesce->Count = count;
+	coalesce->Usecs = usecs;
+	coalesce->Pending = 0;
+	spin_unlock_bh(&Lock);
+
+	wake_up_interruptible(&PasteWait);
+
+	return 0;
+}
+
+// 복사 경로에 classic BPF 필터를 붙임, user_fprog 가 NULL 이면 떼어냄
+// 모든 프로세스의 복사에 적용되므로 CAP_SYS_ADMIN 이 필요, 권한이 없거나 잘못된 필터이면 -2
+long do_sys_kb_set_filter(struct sock_fprog *user_fprog)
+{
+	struct sock_fprog fprog;
+	int error;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_set_filter() Called, address: '0x%p'\n", user_fprog);
+
+	if (!capable(CAP_SYS_ADMIN))
+	{
+		printk(KERN_DEBUG "KBOARD: Permission denied\n");
+
+		return -2;
+	}
+
+	if (user_fprog != NULL && copy_from_user(&fprog, user_fprog, sizeof(fprog)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_from_user, UserAddress: '0x%p'\n", user_fprog);
+
+		return -2;
+	}
+
+	error = kb_filter_replace(&Filter, user_fprog != NULL ? &fprog : NULL, &FilterLock);
+	if (error != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed to attach filter, error: '%d'\n", error);
+
+		return error == -ENOMEM ? -1 : -2;
+	}
+
+	return 0;
+}
+
+// 링 버퍼를 초기화
+long do_sys_kb_init(void)
+{
+	int level;
+
+	// 초기화 중에 타이머가 Lock 을 잡지 않도록 먼저 멈춤
+	del_timer_sync(&ExpiryTimer);
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		hrtimer_cancel(&Coalesce[level].Timer);
+	}
+
+	spin_lock_init(&Lock);
+	spin_lock_bh(&Lock);
+
+	// 링 버퍼의 값을 초기값으로 설정
+	kb_prio_ring_init(&Clipboard);
+	Mode = 0;
+	memset(&Stat, 0, sizeof(Stat));
+	kb_stack_init(&Stack);
+	atomic_long_set(&StackCopied, 0);
+	atomic_long_set(&StackPasted, 0);
+	kb_coalesce_reset();
+
+	spin_unlock_bh(&Lock);
+
+	// 키 저장소는 자체적으로 동기화하므로 Lock 밖에서 비움
+	kb_key_table_clear();
+
+	spin_lock(&LogLock);
+	kb_log_init();
+	spin_unlock(&LogLock);
+
+	return 0;
+}
+
+// 클립보드 동작 방식을 설정
+long do_sys_kb_set_mode(int mode)
+{
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_set_mode() Called, mode: '0x%x'\n", mode);
+
+	// 알 수 없는 모드인지 검사
+	if ((mode & ~KB_MODE_MASK) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Unknown mode, mode: '0x%x'\n", mode);
+
+		return -2;
+	}
+
+	spin_lock_bh(&Lock);
+	WRITE_ONCE(Mode, mode);
+	spin_unlock_bh(&Lock);
+
+	return 0;
+}
+
+// 매개변수로 받은 주소에 클립보드 통계를 넣어줌
+long do_sys_kb_stat(struct kb_stat *user_stat)
+{
+	int level;
+	long stackCopied;
+	long stackPasted;
+	struct kb_stat stat;
+
+	spin_lock_bh(&Lock);
+
+	stat = Stat;
+	stat.Count = 0;
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		stat.Count += Clipboard.Level[level].Count;
+	}
+	stat.Mode = Mode;
+
+	spin_unlock_bh(&Lock);
+
+	// 스택의 값도 포함, Pasted 를 먼저 읽어 Count 가 음수가 되지 않도록 함
+	stackPasted = atomic_long_read(&StackPasted);
+	stackCopied = atomic_long_read(&StackCopied);
+	stat.Copied += stackCopied;
+	stat.Pasted += stackPasted;
+	stat.Count += stackCopied - stackPasted;
+	stat.Keys = atomic_read(&KeyTable.nelems);
+
+	spin_lock(&LogLock);
+	stat.LogHead = LogHead;
+	stat.LogTail = LogTail;
+	spin_unlock(&LogLock);
+
+	// 유저에게 복사는 Lock 밖에서 수행
+	if (copy_to_user(user_stat, &stat, sizeof(stat)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, UserAddress: '0x%p'\n", user_stat);
+
+		return -2;
+	}
+
+	return 0;
+}
+
+// 키에 값을 저장, 이미 있는 키면 값을 바꿈, 메모리가 모자라거나 테이블에 넣지 못하면 -1
+long do_sys_kb_put(int key, int value)
+{
+	struct kb_entry *entry;
+	struct kb_entry *old;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_put() Called, key: '%d', value: '%d'\n", key, value);
+
+	// 전달받은 값이 음수인지 검사
+	if (value < 0)
+	{
+		printk(KERN_DEBUG "KBOARD: value cannot be negative value, value: '%d'\n", value);
+
+		return -2;
+	}
+
+	// 메모리가 모자라면 가득 찬 것과 같이 -1
+	entry = kmalloc(sizeof(*entry), GFP_KERNEL);
+	if (entry == NULL)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed kmalloc, key: '%d'\n", key);
+
+		return -1;
+	}
+	entry->Key = key;
+	entry->Value = value;
+
+	// 키가 없으면 추가, 있으면 기존 항목을 돌려받음
+	rcu_read_lock();
+	old = rhashtable_lookup_get_insert_fast(&KeyTable, &entry->Node, KeyTableParams);
+	if (old != NULL && !IS_ERR(old))
+	{
+		// 기존 항목의 값만 바꿈, 조회하는 쪽은 이전 값이나 새 값 중 하나를 읽음
+		WRITE_ONCE(old->Value, value);
+	}
+	rcu_read_unlock();
+
+	// 새 항목을 사용하지 않은 경우
+	if (old != NULL)
+	{
+		kfree(entry);
+
+		if (IS_ERR(old))
+		{
+			printk(KERN_DEBUG "KBOARD: Failed insert key, key: '%d', error: '%ld'\n", key, PTR_ERR(old));
+
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// 매개변수로 받은 주소에 키에 저장된 값을 넣어줌, 키는 그대로 남음
+long do_sys_kb_get(int key, int *user_value)
+{
+	struct kb_entry *entry;
+	int value;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_get() Called, key: '%d', address: '0x%p'\n", key, user_value);
+
+	rcu_read_lock();
+	entry = rhashtable_lookup(&KeyTable, &key, KeyTableParams);
+	if (entry == NULL)
+	{
+		rcu_read_unlock();
+		printk(KERN_DEBUG "KBOARD: Key not found, key: '%d'\n", key);
+
+		return -1;
+	}
+	value = READ_ONCE(entry->Value);
+	rcu_read_unlock();
+
+	if (copy_to_user(user_value, &value, sizeof(value)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, key: '%d', value: '%d', UserAddress: '0x%p'\n", key, value, user_value);
+
+		return -2;
+	}
+
+	return 0;
+}
+
+// 키를 삭제, 조회 중인 쪽이 끝난 뒤에 메모리를 해제
+long do_sys_kb_del(int key)
+{
+	struct kb_entry *entry;
+	long result = -1;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_del() Called, key: '%d'\n", key);
+
+	rcu_read_lock();
+	entry = rhashtable_lookup(&KeyTable, &key, KeyTableParams);
+	if (entry != NULL && rhashtable_remove_fast(&KeyTable, &entry->Node, KeyTableParams) == 0)
+	{
+		kfree_rcu(entry, Rcu);
+		result = 0;
+	}
+	rcu_read_unlock();
+
+	return result;
+}
+
+// 로그의 끝에 값을 추가하고 그 값의 순번을 돌려줌
+long do_sys_kb_log_append(int item)
+{
+	long sequence;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_log_append() Called, item: '%d'\n", item);
 
 	// 전달받은 값이 음수인지 검사
 	if (item < 0)
@@ -25,89 +814,385 @@ long do_sys_kb_enqueue(int item)
 		return -2;
 	}
 
-	spin_lock(&Lock);
+	spin_lock(&LogLock);
 
-	// 링 버퍼가 가득 찼는지 검사
-	if (Count >= MAX_CLIP)
+	// 가득 찼으면 소비자가 지나간 자리를 회수한 뒤 다시 검사
+	if (LogHead - LogTail >= KB_LOG_SIZE)
 	{
-		printk(KERN_DEBUG "KBOARD: Buffer is full, Count: '%d'\n", Count);
-		spin_unlock(&Lock);
+		kb_log_reclaim();
+		if (LogHead - LogTail >= KB_LOG_SIZE)
+		{
+			printk(KERN_DEBUG "KBOARD: Log is full, Head: '%llu', Tail: '%llu'\n", LogHead, LogTail);
+			spin_unlock(&LogLock);
 
-		return -1;
+			return -1;
+		}
 	}
 
-	// 링 버퍼에 값을 저장하고 Count를 증가
-	Ring[(CurrentIndex + Count) % MAX_CLIP] = item;
-	Count++;
+	Log[LogHead % KB_LOG_SIZE] = item;
+	sequence = LogHead++;
 
-	spin_unlock(&Lock);
+	spin_unlock(&LogLock);
 
-    return 0;
+	return sequence;
 }
 
-// 매개변수로 받은 주소에 링 버퍼에 있는 값을 넣어줌
-long do_sys_kb_dequeue(int *user_buf)
+// 소비자를 등록하고 소비자 번호를 돌려줌, 보관 중인 가장 오래된 값부터 읽게 됨
+long do_sys_kb_log_register(void)
 {
-    printk(KERN_DEBUG "KBOARD: do_sys_kb_dequeue() Called, address: '0x%p'\n", user_buf);
+	int id;
 
-	spin_lock(&Lock);
+	spin_lock(&LogLock);
+
+	for (id = 0; id < KB_LOG_CONSUMERS; id++)
+	{
+		if (!LogConsumer[id].Used)
+		{
+			LogConsumer[id].Used = true;
+			LogConsumer[id].Offset = LogTail;
+			spin_unlock(&LogLock);
+
+			return id;
+		}
+	}
+
+	spin_unlock(&LogLock);
+	printk(KERN_DEBUG "KBOARD: Too many log consumers\n");
+
+	return -1;
+}
+
+// 소비자의 읽기 위치부터 최대 count 개의 값을 읽어 매개변수로 받은 주소에 넣어주고 읽은 개수를 돌려줌
+// 한 소비자 번호는 한 쓰레드만 읽는다고 가정
+long do_sys_kb_log_read(int id, int *user_items, int count)
+{
+	int *items;
+	int index;
+	int read;
+	unsigned long long offset;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_log_read() Called, id: '%d', address: '0x%p', count: '%d'\n", id, user_items, count);
+
+	if (id < 0 || id >= KB_LOG_CONSUMERS || count <= 0)
+	{
+		return -2;
+	}
+	count = min(count, KB_LOG_BATCH_MAX);
 
-	// 링 버퍼가 비어있는지 검사
-	if (Count <= 0)
+	// 메모리가 모자라면 읽을 자리가 없는 것과 같이 -1
+	items = kmalloc_array(count, sizeof(*items), GFP_KERNEL);
+	if (items == NULL)
 	{
-		printk(KERN_DEBUG "KBOARD: Buffer is empty, Count: '%d'\n", Count);
-		spin_unlock(&Lock);
+		printk(KERN_DEBUG "KBOARD: Failed kmalloc_array, id: '%d', count: '%d'\n", id, count);
 
 		return -1;
 	}
 
-	// 링 버퍼의 값을 유저에게 복사해 주고 예외처리
-	if (copy_to_user(user_buf, &Ring[CurrentIndex], sizeof(Ring[CurrentIndex])) != 0)
+	// 소비자가 지나가지 않은 값은 회수되지 않으므로 Lock 안에서 복사해 두면 됨
+	spin_lock(&LogLock);
+
+	if (!LogConsumer[id].Used)
 	{
-		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, Count: '%d', CurrentIndex: '%d', BufferValue: '%d', UserAddress: '0x%p'\n", Count, CurrentIndex, Ring[CurrentIndex], user_buf);
-		spin_unlock(&Lock);
+		spin_unlock(&LogLock);
+		kfree(items);
+		printk(KERN_DEBUG "KBOARD: Log consumer is not registered, id: '%d'\n", id);
 
 		return -2;
 	}
 
-	// 붙여넣기가 끝난 값을 초기화
-	Ring[CurrentIndex] = INIT_VALUE;
+	offset = LogConsumer[id].Offset;
+	read = min_t(unsigned long long, count, LogHead - offset);
+	for (index = 0; index < read; index++)
+	{
+		items[index] = Log[(offset + index) % KB_LOG_SIZE];
+	}
 
-	// CurrentIndex를 다음 칸으로 이동시키고 Count를 감소
-	Count--;
-	CurrentIndex = (CurrentIndex + 1) % MAX_CLIP;
+	spin_unlock(&LogLock);
 
-	spin_unlock(&Lock);
+	// 유저에게 복사해 주고 성공한 경우에만 읽기 위치를 옮김
+	if (copy_to_user(user_items, items, read * sizeof(*items)) != 0)
+	{
+		printk(KERN_DEBUG "KBOARD: Failed copy_to_user, id: '%d', UserAddress: '0x%p'\n", id, user_items);
+		kfree(items);
 
-    return 0;
+		return -2;
+	}
+	kfree(items);
+
+	spin_lock(&LogLock);
+	if (LogConsumer[id].Used && LogConsumer[id].Offset == offset)
+	{
+		LogConsumer[id].Offset = offset + read;
+	}
+	spin_unlock(&LogLock);
+
+	return read;
 }
 
-// 링 버퍼를 초기화
-long do_sys_kb_init(void)
+// 소비자 등록을 해제, 이 소비자만 붙잡고 있던 값은 다음 회수 때 재사용됨
+long do_sys_kb_log_unregister(int id)
 {
-	int index;
+	if (id < 0 || id >= KB_LOG_CONSUMERS)
+	{
+		return -2;
+	}
 
-	spin_lock_init(&Lock);
-	spin_lock(&Lock);
+	spin_lock(&LogLock);
 
-	// 링 버퍼의 값을 초기값으로 설정
-	for (index = 0; index < MAX_CLIP; index++)
+	if (!LogConsumer[id].Used)
 	{
-		Ring[index] = INIT_VALUE;
+		spin_unlock(&LogLock);
+
+		return -2;
 	}
-	Count = 0;
-	CurrentIndex = 0;
+	LogConsumer[id].Used = false;
 
-	spin_unlock(&Lock);
+	spin_unlock(&LogLock);
+
+	return 0;
+}
+
+// 제출, 완료 큐, kb_queue_setup 이 만든 fd 마다 하나씩 가짐
+// 유저가 언제든 공유 메모리를 바꿀 수 있으므로 커널이 바꾸는 SqHead, CqTail 은 따로 보관하고 공유 메모리에는 내보내기만 함
+struct kb_queue
+{
+	struct kb_queue_header *Header;	// vmalloc_user 로 할당하여 유저와 공유
+	struct kb_sqe *Sq;
+	struct kb_cqe *Cq;
+	unsigned int SqEntries;			// 헤더의 값은 유저가 바꿀 수 있으므로 커널은 이 값만 사용
+	unsigned int CqEntries;
+	unsigned int SqMask;
+	unsigned int CqMask;
+	unsigned int SqHead;
+	unsigned int CqTail;
+	bool Canceled;					// 연결된 앞 요청이 실패하여 연결이 끝날 때까지 취소 중, kb_queue_enter 사이에도 이어짐
+	struct mutex Lock;				// 같은 큐에 대한 kb_queue_enter 를 직렬화
+};
+
+static int kb_queue_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct kb_queue *queue = file->private_data;
+
+	return remap_vmalloc_range(vma, queue->Header, vma->vm_pgoff);
+}
+
+static int kb_queue_release(struct inode *inode, struct file *file)
+{
+	struct kb_queue *queue = file->private_data;
+
+	vfree(queue->Header);
+	kfree(queue);
+
+	return 0;
+}
+
+static const struct file_operations kb_queue_fops =
+{
+	.mmap = kb_queue_mmap,
+	.release = kb_queue_release,
+};
+
+// 커널 주소로 붙여넣기, 제출 큐에서 사용
+static long kb_paste(int *item)
+{
+	int priority;
+
+	// 스택 모드에서는 Lock 없이 처리
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		if (kb_stack_pop(&Stack, item) != 0)
+		{
+			return -1;
+		}
+		atomic_long_inc(&StackPasted);
+
+		return 0;
+	}
+
+	spin_lock_bh(&Lock);
+
+	priority = kb_dequeue_front();
+	if (priority < 0)
+	{
+		spin_unlock_bh(&Lock);
+
+		return -1;
+	}
+
+	*item = kb_ring_front(&Clipboard.Level[priority])->Item;
+	kb_prio_ring_pop(&Clipboard, priority);
+	Stat.Pasted++;
+
+	spin_unlock_bh(&Lock);
 
 	return 0;
 }
 
+// entries 칸의 제출 큐와 그 두 배의 완료 큐를 만들고 mmap 할 수 있는 fd 를 돌려줌
+long do_sys_kb_queue_setup(unsigned int entries)
+{
+	struct kb_queue *queue;
+	unsigned int sqOffset;
+	unsigned int cqOffset;
+	int fd;
+
+    printk(KERN_DEBUG "KBOARD: do_sys_kb_queue_setup() Called, entries: '%u'\n", entries);
+
+	if (entries == 0 || entries > KB_QUEUE_ENTRIES_MAX)
+	{
+		printk(KERN_DEBUG "KBOARD: entries out of range, entries: '%u'\n", entries);
+
+		return -2;
+	}
+	entries = roundup_pow_of_two(entries);
+
+	queue = kzalloc(sizeof(*queue), GFP_KERNEL);
+	if (queue == NULL)
+	{
+		return -1;
+	}
+
+	// 헤더와 배열이 서로 다른 캐시 라인에 놓이도록 정렬
+	sqOffset = ALIGN(sizeof(struct kb_queue_header), SMP_CACHE_BYTES);
+	cqOffset = ALIGN(sqOffset + entries * sizeof(struct kb_sqe), SMP_CACHE_BYTES);
+	queue->Header = vmalloc_user(cqOffset + 2 * entries * sizeof(struct kb_cqe));
+	if (queue->Header == NULL)
+	{
+		kfree(queue);
+
+		return -1;
+	}
+
+	queue->SqEntries = entries;
+	queue->CqEntries = 2 * entries;
+	queue->SqMask = queue->SqEntries - 1;
+	queue->CqMask = queue->CqEntries - 1;
+
+	// 헤더의 크기와 위치는 유저에게 알려주기 위한 것
+	queue->Header->SqEntries = queue->SqEntries;
+	queue->Header->CqEntries = queue->CqEntries;
+	queue->Header->SqOffset = sqOffset;
+	queue->Header->CqOffset = cqOffset;
+	queue->Sq = (struct kb_sqe *)((char *)queue->Header + sqOffset);
+	queue->Cq = (struct kb_cqe *)((char *)queue->Header + cqOffset);
+	mutex_init(&queue->Lock);
+
+	fd = anon_inode_getfd("[kboard_queue]", &kb_queue_fops, queue, O_RDWR | O_CLOEXEC);
+	if (fd < 0)
+	{
+		vfree(queue->Header);
+		kfree(queue);
+
+		return -1;
+	}
+
+	return fd;
+}
+
+// 제출 큐에 쌓인 요청을 최대 count 개 차례로 처리하고 결과를 완료 큐에 씀, 처리한 요청 수를 돌려줌
+// 복사와 붙여넣기를 섞을 수 있고, 완료 큐가 가득 차면 남은 요청은 다음 호출에서 처리
+long do_sys_kb_queue_enter(int fd, unsigned int count)
+{
+	struct fd file;
+	struct kb_queue *queue;
+	struct kb_queue_header *header;
+	struct kb_sqe sqe;
+	struct kb_cqe cqe;
+	unsigned int pending;
+	unsigned int done;
+
+	file = fdget(fd);
+	if (file.file == NULL)
+	{
+		return -2;
+	}
+
+	if (file.file->f_op != &kb_queue_fops)
+	{
+		fdput(file);
+
+		return -2;
+	}
+	queue = file.file->private_data;
+	header = queue->Header;
+
+	mutex_lock(&queue->Lock);
+
+	// 유저가 쓴 요청이 SqTail 보다 먼저 보이도록 acquire 로 읽음, 잘못된 SqTail 이어도 한 바퀴를 넘지 않음
+	// 공유 메모리의 값은 언제든 바뀔 수 있으므로 칸 수와 마스크는 커널이 보관한 값만 사용
+	pending = min(smp_load_acquire(&header->SqTail) - queue->SqHead, queue->SqEntries);
+	count = min(count, pending);
+
+	for (done = 0; done < count; done++)
+	{
+		// 완료 큐가 가득 찼으면 멈춤
+		if (queue->CqTail - READ_ONCE(header->CqHead) >= queue->CqEntries)
+		{
+			break;
+		}
+
+		// 처리하는 동안 유저가 바꾸지 못하도록 요청을 복사해 둠
+		memcpy(&sqe, &queue->Sq[queue->SqHead & queue->SqMask], sizeof(sqe));
+		queue->SqHead++;
+
+		cqe.Tag = sqe.Tag;
+		cqe.Item = INIT_VALUE;
+		if (queue->Canceled)
+		{
+			cqe.Result = KB_RESULT_CANCELED;
+		}
+		else if (sqe.Op == KB_SQE_COPY)
+		{
+			cqe.Result = do_sys_kb_enqueue_ttl(sqe.Item, sqe.Priority, sqe.Ttl);
+		}
+		else if (sqe.Op == KB_SQE_PASTE)
+		{
+			cqe.Result = kb_paste(&cqe.Item);
+		}
+		else
+		{
+			cqe.Result = -2;
+		}
+
+		// 연결된 요청이 실패하면 연결의 마지막 요청까지 취소, 연결이 끝나면 다시 실행
+		if ((sqe.Flags & KB_SQE_LINK) == 0)
+		{
+			queue->Canceled = false;
+		}
+		else if (cqe.Result != 0)
+		{
+			queue->Canceled = true;
+		}
+
+		// 완료를 쓴 뒤 CqTail 을 release 로 내보내 유저가 다 쓴 완료만 읽도록 함
+		queue->Cq[queue->CqTail & queue->CqMask] = cqe;
+		queue->CqTail++;
+		smp_store_release(&header->CqTail, queue->CqTail);
+	}
+
+	WRITE_ONCE(header->SqHead, queue->SqHead);
+
+	mutex_unlock(&queue->Lock);
+	fdput(file);
+
+	return done;
+}
+
 SYSCALL_DEFINE1(kb_enqueue, int, item)
 {
     return do_sys_kb_enqueue(item);
 }
 
+SYSCALL_DEFINE2(kb_enqueue_prio, int, item, int, priority)
+{
+	return do_sys_kb_enqueue_prio(item, priority);
+}
+
+SYSCALL_DEFINE3(kb_enqueue_ttl, int, item, int, priority, int, ttl)
+{
+	return do_sys_kb_enqueue_ttl(item, priority, ttl);
+}
+
 SYSCALL_DEFINE1(kb_dequeue, int __user *, user_buf)
 {
     return do_sys_kb_dequeue(user_buf);
@@ -117,3 +1202,73 @@ SYSCALL_DEFINE0(kb_init)
 {
 	return do_sys_kb_init();
 }
+
+SYSCALL_DEFINE1(kb_set_mode, int, mode)
+{
+	return do_sys_kb_set_mode(mode);
+}
+
+SYSCALL_DEFINE1(kb_stat, struct kb_stat __user *, user_stat)
+{
+	return do_sys_kb_stat(user_stat);
+}
+
+SYSCALL_DEFINE2(kb_put, int, key, int, value)
+{
+	return do_sys_kb_put(key, value);
+}
+
+SYSCALL_DEFINE2(kb_get, int, key, int __user *, user_value)
+{
+	return do_sys_kb_get(key, user_value);
+}
+
+SYSCALL_DEFINE1(kb_del, int, key)
+{
+	return do_sys_kb_del(key);
+}
+
+SYSCALL_DEFINE1(kb_log_append, int, item)
+{
+	return do_sys_kb_log_append(item);
+}
+
+SYSCALL_DEFINE0(kb_log_register)
+{
+	return do_sys_kb_log_register();
+}
+
+SYSCALL_DEFINE3(kb_log_read, int, id, int __user *, user_items, int, count)
+{
+	return do_sys_kb_log_read(id, user_items, count);
+}
+
+SYSCALL_DEFINE1(kb_log_unregister, int, id)
+{
+	return do_sys_kb_log_unregister(id);
+}
+
+SYSCALL_DEFINE1(kb_queue_setup, unsigned int, entries)
+{
+	return do_sys_kb_queue_setup(entries);
+}
+
+SYSCALL_DEFINE2(kb_queue_enter, int, fd, unsigned int, count)
+{
+	return do_sys_kb_queue_enter(fd, count);
+}
+
+SYSCALL_DEFINE1(kb_dequeue_wait, int __user *, user_buf)
+{
+	return do_sys_kb_dequeue_wait(user_buf);
+}
+
+SYSCALL_DEFINE3(kb_set_coalesce, int, priority, int, count, int, usecs)
+{
+	return do_sys_kb_set_coalesce(priority, count, usecs);
+}
+
+SYSCALL_DEFINE1(kb_set_filter, struct sock_fprog __user *, user_fprog)
+{
+	return do_sys_kb_set_filter(user_fprog);
+}
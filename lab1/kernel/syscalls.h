@@ -45,6 +45,7 @@ struct semaphore;
 struct sembuf;
 struct shmid_ds;
 struct sockaddr;
+struct sock_fprog;
 struct stat;
 struct stat64;
 struct statfs;
@@ -68,6 +69,7 @@ struct perf_event_attr;
 struct file_handle;
 struct sigaltstack;
 struct rseq;
+struct kb_stat;
 union bpf_attr;
 
 #include <linux/types.h>
@@ -1286,5 +1288,21 @@ static inline long ksys_truncate(const char __user *pathname, loff_t length)
 asmlinkage long sys_kb_enqueue(long item);
 asmlinkage long sys_kb_dequeue(long *user_buf);
 asmlinkage long sys_kb_init(void);
+asmlinkage long sys_kb_enqueue_prio(long item, long priority);
+asmlinkage long sys_kb_set_mode(long mode);
+asmlinkage long sys_kb_stat(struct kb_stat __user *user_stat);
+asmlinkage long sys_kb_put(long key, long value);
+asmlinkage long sys_kb_get(long key, long __user *user_value);
+asmlinkage long sys_kb_del(long key);
+asmlinkage long sys_kb_log_append(long item);
+asmlinkage long sys_kb_log_register(void);
+asmlinkage long sys_kb_log_read(long id, long __user *user_items, long count);
+asmlinkage long sys_kb_log_unregister(long id);
+asmlinkage long sys_kb_enqueue_ttl(long item, long priority, long ttl);
+asmlinkage long sys_kb_queue_setup(long entries);
+asmlinkage long sys_kb_queue_enter(long fd, long count);
+asmlinkage long sys_kb_dequeue_wait(long __user *user_buf);
+asmlinkage long sys_kb_set_coalesce(long priority, long count, long usecs);
+asmlinkage long sys_kb_set_filter(struct sock_fprog __user *user_fprog);
 
 #endif
@@ -6,6 +6,8 @@
 int main(int argc, char* argv[])
 {
 	int userInput;
+	int priority;
+	int ttl;
 	int copyResult;
 
 	// 클립보드에 복사 할 인자를 입력했는지 검사
@@ -16,13 +18,28 @@ int main(int argc, char* argv[])
 	}
 
 	// kboard 라이브러리를 이용하여 클립보드에 입력한 값을 복사
+	// 두 번째 인자가 있으면 우선순위, 세 번째 인자가 있으면 TTL (ms)로 사용
 	userInput = atoi(argv[1]);
-	copyResult = kboard_copy(userInput);
+	if (argc >= 4)
+	{
+		priority = atoi(argv[2]);
+		ttl = atoi(argv[3]);
+		copyResult = kboard_copy_ttl(userInput, priority, ttl);
+	}
+	else if (argc >= 3)
+	{
+		priority = atoi(argv[2]);
+		copyResult = kboard_copy_prio(userInput, priority);
+	}
+	else
+	{
+		copyResult = kboard_copy(userInput);
+	}
 
 	// 클립보드에 값 복사를 실패했을 경우 에러 메시지 출력
 	if (copyResult != 0)
 	{
-		printf("Copy failed, KBoard is full or invalid clip\n");
+		printf("Copy failed, KBoard is full or invalid clip or priority\n");
 		return -1;
 	}
 
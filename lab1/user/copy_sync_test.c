@@ -2,19 +2,43 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
-int main()
+int main(int argc, char* argv[])
 {
 	// 클립보드에 복사 할 값
 	int value = 0;
 
+	// 1 초 동안의 복사 성공, 실패 횟수
+	long success = 0;
+	long fullRetry = 0;
+	time_t lastReport = time(NULL);
+
+	// "overwrite" 인자를 주면 가득 찬 경우 실패하지 않고 가장 오래된 값을 덮어씀
+	if (argc >= 2 && strcmp(argv[1], "overwrite") == 0)
+	{
+		kboard_set_mode(KB_MODE_OVERWRITE);
+	}
+
 	while (1)
 	{
+		// 1 초마다 처리량과 재시도 비율을 출력
+		if (time(NULL) != lastReport)
+		{
+			printf("Copy: '%ld' ops/s, full retry: '%ld'\n", success, fullRetry);
+			success = 0;
+			fullRetry = 0;
+			lastReport = time(NULL);
+		}
+
 		// 클립보드가 가득 찼으면 value 값을 증가 시키지 않음
 		if (kboard_copy(value) != 0)
 		{
+			fullRetry++;
 			continue;
 		}
+		success++;
 
 		// 복사 할 값을 1 만큼 증가
 		value++;
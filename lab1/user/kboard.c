@@ -1,6 +1,7 @@
 #include "kboard.h"
 
 #include <stdio.h>
+#include <sys/mman.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
@@ -10,14 +11,146 @@ long kboard_copy(int clip)
 	return syscall(335, clip);
 }
 
+// 우선순위를 지정하여 클립보드에 복사
+long kboard_copy_prio(int clip, int priority)
+{
+	return syscall(338, clip, priority);
+}
+
+// TTL 을 지정하여 클립보드에 복사
+long kboard_copy_ttl(int clip, int priority, int ttl)
+{
+	return syscall(348, clip, priority, ttl);
+}
+
 // 클립보드의 값을 붙여넣기
 int kboard_paste(int* clip)
 {
 	return syscall(336, clip);
 }
 
+// 값이 생길 때까지 기다렸다가 붙여넣기
+long kboard_paste_wait(int *clip)
+{
+	return syscall(351, clip);
+}
+
+// 기다리는 쪽을 깨우는 주기를 설정
+long kboard_set_coalesce(int priority, int count, int usecs)
+{
+	return syscall(352, priority, count, usecs);
+}
+
+// 복사 필터를 붙이거나 뗌
+long kboard_set_filter(const struct sock_fprog *filter)
+{
+	return syscall(353, filter);
+}
+
 // 클립보드 초기화
 void kboard_init()
 {
 	syscall(337);
 }
+
+// 클립보드 동작 방식 설정
+long kboard_set_mode(int mode)
+{
+	return syscall(339, mode);
+}
+
+// 클립보드 통계
+long kboard_stat(struct kb_stat* stat)
+{
+	return syscall(340, stat);
+}
+
+// 키에 값을 저장
+long kboard_put(int key, int value)
+{
+	return syscall(341, key, value);
+}
+
+// 키에 저장된 값을 조회
+long kboard_get(int key, int* value)
+{
+	return syscall(342, key, value);
+}
+
+// 키를 삭제
+long kboard_del(int key)
+{
+	return syscall(343, key);
+}
+
+// 로그에 값을 추가
+long kboard_log_append(int clip)
+{
+	return syscall(344, clip);
+}
+
+// 로그 소비자 등록
+long kboard_log_register()
+{
+	return syscall(345);
+}
+
+// 로그에서 여러 개의 값을 읽음
+long kboard_log_read(int id, int* clips, int count)
+{
+	return syscall(346, id, clips, count);
+}
+
+// 로그 소비자 등록 해제
+long kboard_log_unregister(int id)
+{
+	return syscall(347, id);
+}
+
+// 제출, 완료 큐를 만들고 매핑
+long kboard_queue_setup(struct kboard_queue *queue, unsigned int entries)
+{
+	struct kb_queue_header *header;
+
+	queue->fd = syscall(349, entries);
+	if (queue->fd < 0)
+	{
+		return -1;
+	}
+
+	// 헤더만 먼저 매핑해 전체 크기를 알아낸 뒤 다시 매핑
+	header = mmap(NULL, sizeof(*header), PROT_READ, MAP_SHARED, queue->fd, 0);
+	if (header == MAP_FAILED)
+	{
+		close(queue->fd);
+		return -1;
+	}
+	queue->size = header->CqOffset + header->CqEntries * sizeof(struct kb_cqe);
+	munmap(header, sizeof(*header));
+
+	header = mmap(NULL, queue->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue->fd, 0);
+	if (header == MAP_FAILED)
+	{
+		close(queue->fd);
+		return -1;
+	}
+
+	queue->header = header;
+	queue->sqes = (struct kb_sqe *)((char *)header + header->SqOffset);
+	queue->cqes = (struct kb_cqe *)((char *)header + header->CqOffset);
+
+	return 0;
+}
+
+// 제출 큐에 쌓인 요청을 처리하게 함
+long kboard_queue_enter(struct kboard_queue *queue, unsigned int count)
+{
+	return syscall(350, queue->fd, count);
+}
+
+// 제출, 완료 큐를 닫음
+void kboard_queue_exit(struct kboard_queue *queue)
+{
+	munmap(queue->header, queue->size);
+	close(queue->fd);
+}
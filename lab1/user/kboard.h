@@ -1,10 +1,79 @@
 #pragma once
 
+#include <linux/filter.h>
+
+// KB_PRIO_*, KB_MODE_*, struct kb_stat 을 커널과 공유
+#include "../kernel/kboard_ring.h"
+
+// struct kb_filter_data 를 커널과 공유
+#include "../kernel/kboard_filter.h"
+
 // 매개변수로 받은 정수 값을 클립보드로 복사
 long kboard_copy(int clip);
 
+// 매개변수로 받은 정수 값을 지정한 우선순위(0 ~ 63, 클수록 먼저 붙여넣기 됨)로 클립보드에 복사
+long kboard_copy_prio(int clip, int priority);
+
+// 매개변수로 받은 정수 값을 지정한 우선순위로 클립보드에 복사, ttl 밀리초가 지나면 붙여넣기 되지 않음 (0 이면 만료되지 않음)
+long kboard_copy_ttl(int clip, int priority, int ttl);
+
 // 매개변수로 받은 주소에 클립보드로 부터 값을 붙여넣기 해줌
 int kboard_paste(int *clip);
 
+// 클립보드에 값이 생길 때까지 기다린 뒤 매개변수로 받은 주소에 붙여넣기 해줌
+long kboard_paste_wait(int *clip);
+
+// 해당 우선순위의 값을 기다리는 쪽을 count 개마다, 또는 첫 값 뒤로 usecs 마이크로초마다 한 번 깨움 (기본 1 개마다)
+long kboard_set_coalesce(int priority, int count, int usecs);
+
+// 복사할 값을 거르거나 바꾸는 classic BPF 필터를 붙임 (kboard_filter.h), NULL 이면 떼어냄, 관리자 권한 필요
+long kboard_set_filter(const struct sock_fprog *filter);
+
 // 클립보드 초기화
 void kboard_init();
+
+// 클립보드 동작 방식 설정, KB_MODE_* 조합
+long kboard_set_mode(int mode);
+
+// 매개변수로 받은 주소에 클립보드 통계를 넣어줌
+long kboard_stat(struct kb_stat *stat);
+
+// 키에 값을 저장, 이미 있는 키면 값을 바꿈, 저장하지 못하면 -1, 음수 값이면 -2
+long kboard_put(int key, int value);
+
+// 매개변수로 받은 주소에 키에 저장된 값을 넣어줌, 키가 없으면 -1
+long kboard_get(int key, int *value);
+
+// 키를 삭제, 키가 없으면 -1
+long kboard_del(int key);
+
+// 로그의 끝에 값을 추가하고 그 값의 순번을 돌려줌, 가득 참 -1
+long kboard_log_append(int clip);
+
+// 로그 소비자를 등록하고 소비자 번호를 돌려줌
+long kboard_log_register();
+
+// 소비자의 읽기 위치부터 최대 count 개의 값을 읽고 읽은 개수를 돌려줌
+long kboard_log_read(int id, int *clips, int count);
+
+// 로그 소비자 등록을 해제
+long kboard_log_unregister(int id);
+
+// 제출, 완료 큐에 물린 fd
+struct kboard_queue
+{
+	int fd;
+	struct kb_queue_header *header;
+	struct kb_sqe *sqes;
+	struct kb_cqe *cqes;
+	unsigned long size;		// 매핑 크기
+};
+
+// entries 칸의 제출 큐를 만들고 매핑, 실패하면 -1
+long kboard_queue_setup(struct kboard_queue *queue, unsigned int entries);
+
+// 제출 큐에 쌓인 요청을 최대 count 개 처리하게 하고 처리한 개수를 돌려줌
+long kboard_queue_enter(struct kboard_queue *queue, unsigned int count);
+
+// 매핑을 풀고 fd 를 닫음
+void kboard_queue_exit(struct kboard_queue *queue);
@@ -0,0 +1,524 @@
+#define _GNU_SOURCE
+
+#include "kboard.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// 쓰레드 하나가 보관할 수 있는 지연 시간 표본의 최대 개수
+#define LATENCY_SAMPLE_MAX (1 << 16)
+
+// 측정할 수 있는 CPU 의 최대 개수
+#define CPU_MAX (1024)
+
+// CPU 배치 방식
+enum Layout
+{
+	LAYOUT_COMPACT,	// 한 소켓의 코어를 먼저 채운 뒤 다음 소켓으로 넘어감
+	LAYOUT_SCATTER,	// 소켓을 번갈아 가며 배치
+	LAYOUT_COUNT,
+};
+
+static const char *LAYOUT_NAME[LAYOUT_COUNT] = { "compact", "scatter" };
+
+// 쓰레드별 측정 결과
+struct ThreadStat
+{
+	bool isProducer;
+	int cpu;
+	long long success;		// 성공한 복사, 붙여넣기 횟수
+	long long retry;		// 가득 참(복사), 비어 있음(붙여넣기)으로 실패한 횟수
+	long long cpuTimeNs;	// 쓰레드가 사용한 CPU 시간
+	long long sampleCount;	// 지금까지 관찰한 지연 시간의 개수
+	long long maxLatency;	// 표본에 남지 않은 값까지 포함한 실제 최대 지연 시간 (ns)
+	uint64_t randomState;	// 저수지 표본 추출에 사용할 난수 상태
+	long long *samples;		// 성공한 호출의 지연 시간 (ns)
+};
+
+// CPU 의 소켓, 코어 번호
+struct CpuTopology
+{
+	int cpu;
+	int socket;
+	int core;
+};
+
+static atomic_bool Running;
+static atomic_int ReadyCount;
+
+static long long NowNs(clockid_t clock)
+{
+	struct timespec now;
+
+	clock_gettime(clock, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+// 저수지 표본 추출로 지연 시간을 기록, 표본 배열이 가득 차도 전체 분포를 대표하도록 유지
+static void RecordLatency(struct ThreadStat *stat, long long latency)
+{
+	uint64_t slot;
+
+	if (latency > stat->maxLatency)
+	{
+		stat->maxLatency = latency;
+	}
+
+	if (stat->sampleCount < LATENCY_SAMPLE_MAX)
+	{
+		stat->samples[stat->sampleCount++] = latency;
+		return;
+	}
+
+	stat->sampleCount++;
+	slot = NextRandom(&stat->randomState) % (uint64_t)stat->sampleCount;
+	if (slot < LATENCY_SAMPLE_MAX)
+	{
+		stat->samples[slot] = latency;
+	}
+}
+
+static void PinToCpu(int cpu)
+{
+	cpu_set_t set;
+
+	if (cpu < 0)
+	{
+		return;
+	}
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// 모든 쓰레드가 준비될 때까지 기다린 뒤 측정 시작
+static void WaitForStart(void)
+{
+	atomic_fetch_add(&ReadyCount, 1);
+	while (!atomic_load(&Running))
+	{
+		sched_yield();
+	}
+}
+
+// 생산자: 클립보드가 가득 차면 재시도하면서 계속 복사
+static void *Producer(void *argument)
+{
+	struct ThreadStat *stat = argument;
+	long long cpuStart;
+	long long begin;
+	int value = 0;
+
+	PinToCpu(stat->cpu);
+	WaitForStart();
+	cpuStart = NowNs(CLOCK_THREAD_CPUTIME_ID);
+
+	while (atomic_load_explicit(&Running, memory_order_relaxed))
+	{
+		begin = NowNs(CLOCK_MONOTONIC);
+		if (kboard_copy(value) != 0)
+		{
+			stat->retry++;
+			continue;
+		}
+
+		RecordLatency(stat, NowNs(CLOCK_MONOTONIC) - begin);
+		stat->success++;
+		value++;
+	}
+
+	stat->cpuTimeNs = NowNs(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+
+	return NULL;
+}
+
+// 소비자: 클립보드가 비어 있으면 재시도하면서 계속 붙여넣기
+static void *Consumer(void *argument)
+{
+	struct ThreadStat *stat = argument;
+	long long cpuStart;
+	long long begin;
+	int clip;
+
+	PinToCpu(stat->cpu);
+	WaitForStart();
+	cpuStart = NowNs(CLOCK_THREAD_CPUTIME_ID);
+
+	while (atomic_load_explicit(&Running, memory_order_relaxed))
+	{
+		begin = NowNs(CLOCK_MONOTONIC);
+		if (kboard_paste(&clip) != 0)
+		{
+			stat->retry++;
+			continue;
+		}
+
+		RecordLatency(stat, NowNs(CLOCK_MONOTONIC) - begin);
+		stat->success++;
+	}
+
+	stat->cpuTimeNs = NowNs(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+
+	return NULL;
+}
+
+static int ReadTopologyValue(int cpu, const char *name)
+{
+	char path[128];
+	FILE *file;
+	int value = 0;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+	file = fopen(path, "r");
+	if (file == NULL)
+	{
+		return 0;
+	}
+
+	if (fscanf(file, "%d", &value) != 1)
+	{
+		value = 0;
+	}
+	fclose(file);
+
+	return value;
+}
+
+static int CompareCompact(const void *left, const void *right)
+{
+	const struct CpuTopology *a = left;
+	const struct CpuTopology *b = right;
+
+	if (a->socket != b->socket)
+	{
+		return a->socket - b->socket;
+	}
+	if (a->core != b->core)
+	{
+		return a->core - b->core;
+	}
+	return a->cpu - b->cpu;
+}
+
+// 현재 프로세스가 사용할 수 있는 CPU 를 배치 방식에 맞는 순서로 정렬
+static int BuildCpuOrder(enum Layout layout, int *order)
+{
+	struct CpuTopology topology[CPU_MAX];
+	int used[CPU_MAX] = { 0 };
+	cpu_set_t allowed;
+	int count = 0;
+	int placed = 0;
+	int cpu;
+	int index;
+	int lastSocket;
+
+	sched_getaffinity(0, sizeof(allowed), &allowed);
+	for (cpu = 0; cpu < CPU_MAX && cpu < CPU_SETSIZE; cpu++)
+	{
+		if (!CPU_ISSET(cpu, &allowed))
+		{
+			continue;
+		}
+
+		topology[count].cpu = cpu;
+		topology[count].socket = ReadTopologyValue(cpu, "physical_package_id");
+		topology[count].core = ReadTopologyValue(cpu, "core_id");
+		count++;
+	}
+
+	qsort(topology, count, sizeof(topology[0]), CompareCompact);
+
+	if (layout == LAYOUT_COMPACT)
+	{
+		for (index = 0; index < count; index++)
+		{
+			order[index] = topology[index].cpu;
+		}
+		return count;
+	}
+
+	// 소켓이 바뀔 때마다 하나씩 골라 소켓을 번갈아 사용
+	while (placed < count)
+	{
+		lastSocket = -1;
+		for (index = 0; index < count; index++)
+		{
+			if (used[index] || topology[index].socket == lastSocket)
+			{
+				continue;
+			}
+
+			used[index] = 1;
+			order[placed++] = topology[index].cpu;
+			lastSocket = topology[index].socket;
+		}
+	}
+
+	return count;
+}
+
+static int CompareLongLong(const void *left, const void *right)
+{
+	long long a = *(const long long *)left;
+	long long b = *(const long long *)right;
+
+	return (a > b) - (a < b);
+}
+
+// 같은 역할의 쓰레드 표본을 모아 백분위수를 출력, 최대값은 표본이 아닌 쓰레드별 실제 최대값
+static void WritePercentiles(FILE *output, struct ThreadStat *stats, int first, int count)
+{
+	static const double PERCENTILES[] = { 0.50, 0.90, 0.99, 0.999 };
+	long long *merged;
+	long long maxLatency = 0;
+	long long total = 0;
+	long long position = 0;
+	long long kept;
+	int index;
+	int percentile;
+
+	for (index = first; index < first + count; index++)
+	{
+		total += stats[index].sampleCount < LATENCY_SAMPLE_MAX ? stats[index].sampleCount : LATENCY_SAMPLE_MAX;
+	}
+
+	if (total == 0)
+	{
+		fprintf(output, ",,,,,");
+		return;
+	}
+
+	merged = malloc(sizeof(long long) * total);
+	for (index = first; index < first + count; index++)
+	{
+		kept = stats[index].sampleCount < LATENCY_SAMPLE_MAX ? stats[index].sampleCount : LATENCY_SAMPLE_MAX;
+		memcpy(&merged[position], stats[index].samples, sizeof(long long) * kept);
+		position += kept;
+		if (stats[index].maxLatency > maxLatency)
+		{
+			maxLatency = stats[index].maxLatency;
+		}
+	}
+	qsort(merged, total, sizeof(long long), CompareLongLong);
+
+	for (percentile = 0; percentile < (int)(sizeof(PERCENTILES) / sizeof(PERCENTILES[0])); percentile++)
+	{
+		fprintf(output, ",%lld", merged[(long long)(PERCENTILES[percentile] * (total - 1))]);
+	}
+	fprintf(output, ",%lld", maxLatency);
+
+	free(merged);
+}
+
+// seconds 초 동안 잠듦, 시그널로 깨어나면 남은 시간만큼 다시 잠듦
+static void SleepSeconds(int seconds)
+{
+	struct timespec remain = { .tv_sec = seconds, .tv_nsec = 0 };
+
+	while (nanosleep(&remain, &remain) != 0 && errno == EINTR)
+	{
+	}
+}
+
+// 생산자, 소비자 수와 배치 방식 하나에 대해 측정하고 CSV 한 줄을 출력
+static void RunCase(FILE *output, enum Layout layout, int producers, int consumers, int duration)
+{
+	struct ThreadStat *stats;
+	pthread_t *threads;
+	int cpuOrder[CPU_MAX];
+	int cpuCount;
+	int threadCount = producers + consumers;
+	int index;
+	long long enqueue = 0, dequeue = 0;
+	long long fullRetry = 0, emptyRetry = 0;
+	long long cpuTime = 0;
+	long long begin, elapsed;
+	int clip;
+
+	cpuCount = BuildCpuOrder(layout, cpuOrder);
+
+	stats = calloc(threadCount, sizeof(struct ThreadStat));
+	threads = malloc(sizeof(pthread_t) * threadCount);
+
+	// 이전 측정의 값이 남지 않도록 클립보드를 비움
+	kboard_init();
+	while (kboard_paste(&clip) == 0)
+	{
+	}
+
+	atomic_store(&Running, false);
+	atomic_store(&ReadyCount, 0);
+
+	// 생산자를 앞쪽, 소비자를 뒤쪽에 두고 CPU 를 순서대로 할당
+	for (index = 0; index < threadCount; index++)
+	{
+		stats[index].isProducer = index < producers;
+		stats[index].cpu = cpuCount > 0 ? cpuOrder[index % cpuCount] : -1;
+		stats[index].randomState = 0x9E3779B97F4A7C15ULL ^ (uint64_t)(index + 1);
+		stats[index].samples = malloc(sizeof(long long) * LATENCY_SAMPLE_MAX);
+		pthread_create(&threads[index], NULL,
+			stats[index].isProducer ? Producer : Consumer, &stats[index]);
+	}
+
+	while (atomic_load(&ReadyCount) < threadCount)
+	{
+		sched_yield();
+	}
+
+	begin = NowNs(CLOCK_MONOTONIC);
+	atomic_store(&Running, true);
+	SleepSeconds(duration);
+	atomic_store(&Running, false);
+
+	for (index = 0; index < threadCount; index++)
+	{
+		pthread_join(threads[index], NULL);
+	}
+	elapsed = NowNs(CLOCK_MONOTONIC) - begin;
+
+	for (index = 0; index < threadCount; index++)
+	{
+		if (stats[index].isProducer)
+		{
+			enqueue += stats[index].success;
+			fullRetry += stats[index].retry;
+		}
+		else
+		{
+			dequeue += stats[index].success;
+			emptyRetry += stats[index].retry;
+		}
+		cpuTime += stats[index].cpuTimeNs;
+	}
+
+	fprintf(output, "%s,%d,%d,%.3f,%lld,%lld,%.1f,%.4f,%.4f,%.1f",
+		LAYOUT_NAME[layout], producers, consumers, elapsed / 1e9,
+		enqueue, dequeue,
+		(enqueue + dequeue) / (elapsed / 1e9),
+		enqueue + fullRetry > 0 ? (double)fullRetry / (enqueue + fullRetry) : 0.0,
+		dequeue + emptyRetry > 0 ? (double)emptyRetry / (dequeue + emptyRetry) : 0.0,
+		enqueue + dequeue > 0 ? (double)cpuTime / (enqueue + dequeue) : 0.0);
+	WritePercentiles(output, stats, 0, producers);
+	WritePercentiles(output, stats, producers, consumers);
+	fprintf(output, "\n");
+	fflush(output);
+
+	for (index = 0; index < threadCount; index++)
+	{
+		free(stats[index].samples);
+	}
+	free(stats);
+	free(threads);
+}
+
+static void PrintUsage(const char *name)
+{
+	printf("Usage: %s [-p max producers] [-c max consumers] [-d seconds] [-l compact|scatter|all] [-o output.csv]\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+	int maxProducers = 4;
+	int maxConsumers = 4;
+	int duration = 3;
+	int firstLayout = 0, lastLayout = LAYOUT_COUNT - 1;
+	int layout, producers, consumers;
+	FILE *output = stdout;
+	int option;
+
+	while ((option = getopt(argc, argv, "p:c:d:l:o:h")) != -1)
+	{
+		switch (option)
+		{
+		case 'p':
+			maxProducers = atoi(optarg);
+			break;
+		case 'c':
+			maxConsumers = atoi(optarg);
+			break;
+		case 'd':
+			duration = atoi(optarg);
+			break;
+		case 'l':
+			if (strcmp(optarg, "compact") == 0)
+			{
+				firstLayout = lastLayout = LAYOUT_COMPACT;
+			}
+			else if (strcmp(optarg, "scatter") == 0)
+			{
+				firstLayout = lastLayout = LAYOUT_SCATTER;
+			}
+			else if (strcmp(optarg, "all") == 0)
+			{
+				firstLayout = 0;
+				lastLayout = LAYOUT_COUNT - 1;
+			}
+			else
+			{
+				printf("Unknown layout, layout: '%s'\n", optarg);
+				PrintUsage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'o':
+			output = fopen(optarg, "w");
+			if (output == NULL)
+			{
+				printf("Failed to open output file, path: '%s'\n", optarg);
+				return -1;
+			}
+			break;
+		default:
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (maxProducers < 1 || maxConsumers < 1 || duration < 1)
+	{
+		PrintUsage(argv[0]);
+		return -1;
+	}
+
+	fprintf(output, "layout,producers,consumers,seconds,enqueue_ops,dequeue_ops,ops_per_sec,"
+		"full_retry_rate,empty_retry_rate,cpu_ns_per_op,"
+		"enqueue_p50_ns,enqueue_p90_ns,enqueue_p99_ns,enqueue_p999_ns,enqueue_max_ns,"
+		"dequeue_p50_ns,dequeue_p90_ns,dequeue_p99_ns,dequeue_p999_ns,dequeue_max_ns\n");
+
+	// 생산자, 소비자 수를 2 배씩 늘려가며 측정
+	for (layout = firstLayout; layout <= lastLayout; layout++)
+	{
+		for (producers = 1; producers <= maxProducers; producers *= 2)
+		{
+			for (consumers = 1; consumers <= maxConsumers; consumers *= 2)
+			{
+				RunCase(output, layout, producers, consumers, duration);
+			}
+		}
+	}
+
+	if (output != stdout)
+	{
+		fclose(output);
+	}
+
+	return 0;
+}
@@ -0,0 +1,233 @@
+#include "kboard_uring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef KBOARD_URING_DEVICE
+#define KBOARD_URING_DEVICE "/dev/kboard"
+#endif
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int fd, unsigned submit, unsigned wait, unsigned flags)
+{
+	return syscall(__NR_io_uring_enter, fd, submit, wait, flags, NULL, 0);
+}
+
+// 제출 큐, 완료 큐, 요청 배열을 매핑
+static int kboard_uring_map(struct kboard_uring *ring, struct io_uring_params *params)
+{
+	ring->sq_map_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+	ring->cq_map_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+
+	// 한 번의 매핑으로 두 큐를 함께 쓸 수 있으면 큰 쪽으로 매핑
+	if (params->features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cq_map_size > ring->sq_map_size)
+		{
+			ring->sq_map_size = ring->cq_map_size;
+		}
+		ring->cq_map_size = ring->sq_map_size;
+	}
+
+	ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ring->sq_map == MAP_FAILED)
+	{
+		return -1;
+	}
+
+	ring->cq_map = ring->sq_map;
+	if (!(params->features & IORING_FEAT_SINGLE_MMAP))
+	{
+		ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+		if (ring->cq_map == MAP_FAILED)
+		{
+			munmap(ring->sq_map, ring->sq_map_size);
+			return -1;
+		}
+	}
+
+	ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+	{
+		if (ring->cq_map != ring->sq_map)
+		{
+			munmap(ring->cq_map, ring->cq_map_size);
+		}
+		munmap(ring->sq_map, ring->sq_map_size);
+		return -1;
+	}
+
+	ring->sq_head = (unsigned *)((char *)ring->sq_map + params->sq_off.head);
+	ring->sq_tail = (unsigned *)((char *)ring->sq_map + params->sq_off.tail);
+	ring->sq_mask = (unsigned *)((char *)ring->sq_map + params->sq_off.ring_mask);
+	ring->sq_array = (unsigned *)((char *)ring->sq_map + params->sq_off.array);
+	ring->cq_head = (unsigned *)((char *)ring->cq_map + params->cq_off.head);
+	ring->cq_tail = (unsigned *)((char *)ring->cq_map + params->cq_off.tail);
+	ring->cq_mask = (unsigned *)((char *)ring->cq_map + params->cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_map + params->cq_off.cqes);
+
+	return 0;
+}
+
+// io_uring 을 만들고 /dev/kboard 를 엶
+int kboard_uring_init(struct kboard_uring *ring, unsigned entries)
+{
+	struct io_uring_params params;
+	int error;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&params, 0, sizeof(params));
+
+	ring->device = open(KBOARD_URING_DEVICE, O_RDWR);
+	if (ring->device < 0)
+	{
+		return -1;
+	}
+
+	ring->fd = io_uring_setup(entries, &params);
+	if (ring->fd < 0)
+	{
+		error = errno;
+		close(ring->device);
+		errno = error;
+		return -1;
+	}
+
+	if (kboard_uring_map(ring, &params) != 0)
+	{
+		error = errno;
+		close(ring->fd);
+		close(ring->device);
+		errno = error;
+		return -1;
+	}
+
+	// 완료 큐는 제출 큐보다 크므로 제출 큐 크기만큼만 처리 중이면 완료가 넘치지 않음
+	ring->entries = params.sq_entries;
+
+	return 0;
+}
+
+// io_uring 과 /dev/kboard 를 닫음
+void kboard_uring_exit(struct kboard_uring *ring)
+{
+	munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_map != ring->sq_map)
+	{
+		munmap(ring->cq_map, ring->cq_map_size);
+	}
+	munmap(ring->sq_map, ring->sq_map_size);
+	close(ring->fd);
+	close(ring->device);
+}
+
+// 제출 큐의 빈 칸에 read, write 요청을 채움
+static int kboard_uring_queue(struct kboard_uring *ring, int opcode, void *clips, int count, unsigned long long tag)
+{
+	struct io_uring_sqe *sqe;
+	unsigned tail;
+	unsigned index;
+
+	if (count <= 0)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ring->queued + ring->inflight >= ring->entries)
+	{
+		errno = EBUSY;
+		return -1;
+	}
+
+	// 커널은 제출한 요청을 읽어 간 뒤 head 를 옮기므로 tail 은 이 쓰레드만 바꿈
+	tail = *ring->sq_tail + ring->queued;
+	index = tail & *ring->sq_mask;
+	sqe = &ring->sqes[index];
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = ring->device;
+	sqe->addr = (unsigned long)clips;
+	sqe->len = count * sizeof(int);
+	sqe->off = 0;
+	sqe->user_data = tag;
+
+	ring->sq_array[index] = index;
+	ring->queued++;
+
+	return 0;
+}
+
+// 복사 요청을 큐에 쌓음
+int kboard_uring_copy(struct kboard_uring *ring, const int *clips, int count, unsigned long long tag)
+{
+	return kboard_uring_queue(ring, IORING_OP_WRITE, (void *)clips, count, tag);
+}
+
+// 붙여넣기 요청을 큐에 쌓음
+int kboard_uring_paste(struct kboard_uring *ring, int *clips, int count, unsigned long long tag)
+{
+	return kboard_uring_queue(ring, IORING_OP_READ, clips, count, tag);
+}
+
+// 쌓인 요청을 제출하고 완료를 기다림
+int kboard_uring_submit(struct kboard_uring *ring, unsigned wait)
+{
+	unsigned tail = *ring->sq_tail + ring->queued;
+	unsigned pending;
+
+	// 채운 요청이 tail 보다 먼저 보이도록 release 로 tail 을 옮김
+	__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+	ring->inflight += ring->queued;
+	ring->queued = 0;
+
+	// 처리 중인 요청보다 많이 기다리면 끝나지 않으므로 줄임
+	if (wait > ring->inflight)
+	{
+		wait = ring->inflight;
+	}
+
+	// 이전 제출이 실패해 커널이 가져가지 못한 요청까지 함께 제출
+	pending = tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	if (pending == 0 && wait == 0)
+	{
+		return 0;
+	}
+
+	return io_uring_enter(ring->fd, pending, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+}
+
+// 완료된 요청을 거둠
+int kboard_uring_reap(struct kboard_uring *ring, struct kboard_uring_completion *completions, int max)
+{
+	struct io_uring_cqe *cqe;
+	unsigned head = *ring->cq_head;
+	unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	int reaped = 0;
+
+	while (head != tail && reaped < max)
+	{
+		cqe = &ring->cqes[head & *ring->cq_mask];
+		completions[reaped].tag = cqe->user_data;
+		completions[reaped].result = cqe->res < 0 ? cqe->res : cqe->res / (int)sizeof(int);
+		reaped++;
+		head++;
+	}
+
+	// 읽은 완료 칸을 커널이 다시 쓰도록 release 로 head 를 옮김
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+	ring->inflight -= reaped;
+
+	return reaped;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+
+// io_uring 으로 /dev/kboard 에 비동기 복사, 붙여넣기를 묶어 제출하는 클라이언트
+// 요청마다 시스템 콜로 기다리지 않고 여러 요청을 큐에 쌓은 뒤 kboard_uring_submit 한 번으로 제출하고 완료는 kboard_uring_reap 으로 거둠
+// 복사는 __s32 값 배열의 write, 붙여넣기는 read 이므로 lab2 모듈의 /dev/kboard 와 io_uring 의 READ, WRITE (리눅스 5.6 이상)가 필요
+// 요청에 넘긴 배열은 완료를 거둘 때까지 유지해야 함
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// 완료된 요청
+struct kboard_uring_completion
+{
+	unsigned long long tag;	// 요청할 때 넘긴 값
+	int result;				// 옮긴 값의 개수, 실패하면 -errno (가득 참 -ENOSPC, 음수 값 -EINVAL), 비어 있으면 붙여넣기는 0
+};
+
+struct kboard_uring
+{
+	int fd;					// io_uring
+	int device;				// /dev/kboard
+	unsigned entries;		// 동시에 큐에 쌓거나 처리 중일 수 있는 최대 요청 수
+
+	// 커널과 공유하는 제출 큐
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	struct io_uring_sqe *sqes;
+
+	// 커널과 공유하는 완료 큐
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	void *sq_map;
+	void *cq_map;
+	size_t sq_map_size;
+	size_t cq_map_size;
+	size_t sqes_size;
+
+	unsigned queued;		// 큐에 쌓았지만 제출하지 않은 요청 수
+	unsigned inflight;		// 제출했지만 완료를 거두지 않은 요청 수
+};
+
+// entries 개의 요청을 동시에 처리할 수 있는 io_uring 을 만들고 /dev/kboard 를 엶, 실패하면 -1 (errno 설정)
+int kboard_uring_init(struct kboard_uring *ring, unsigned entries);
+
+// io_uring 과 /dev/kboard 를 닫음, 처리 중인 요청의 완료는 버려짐
+void kboard_uring_exit(struct kboard_uring *ring);
+
+// clips 의 count 개 값을 복사하는 요청을 큐에 쌓음, 큐가 가득 찼으면 -1 (errno EBUSY), 제출은 kboard_uring_submit
+int kboard_uring_copy(struct kboard_uring *ring, const int *clips, int count, unsigned long long tag);
+
+// 최대 count 개를 clips 에 붙여넣기 하는 요청을 큐에 쌓음, 큐가 가득 찼으면 -1 (errno EBUSY)
+int kboard_uring_paste(struct kboard_uring *ring, int *clips, int count, unsigned long long tag);
+
+// 쌓인 요청을 한 번의 시스템 콜로 제출하고 최소 wait 개가 완료될 때까지 기다림, 제출한 개수 또는 -1 (errno 설정)
+int kboard_uring_submit(struct kboard_uring *ring, unsigned wait);
+
+// 완료된 요청을 최대 max 개 거둬 completions 에 넣고 개수를 돌려줌, 기다리지 않음
+int kboard_uring_reap(struct kboard_uring *ring, struct kboard_uring_completion *completions, int max);
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 int main()
 {
@@ -14,16 +15,52 @@ int main()
 	// kboard_paste() 함수를 호출한 횟수
 	int iteration = 0;
 
+	// 1 초 동안의 붙여넣기 성공, 실패 횟수
+	long success = 0;
+	long emptyRetry = 0;
+	time_t lastReport = time(NULL);
+
+	// 덮어쓰기로 인해 받지 못한 값의 개수
+	struct kb_stat stat;
+	long long lastDropped;
+	long missed = 0;
+	int overwrite;
+
+	kboard_stat(&stat);
+	lastDropped = stat.Dropped;
+	overwrite = (stat.Mode & KB_MODE_OVERWRITE) != 0;
+
 	while (1)
 	{
 		iteration++;
 
+		// 1 초마다 처리량과 재시도 비율을 출력
+		if (time(NULL) != lastReport)
+		{
+			kboard_stat(&stat);
+			overwrite = (stat.Mode & KB_MODE_OVERWRITE) != 0;
+			printf("Paste: '%ld' ops/s, empty retry: '%ld', missed: '%ld', dropped: '%lld'\n", success, emptyRetry, missed, stat.Dropped - lastDropped);
+			success = 0;
+			emptyRetry = 0;
+			missed = 0;
+			lastDropped = stat.Dropped;
+			lastReport = time(NULL);
+		}
+
 		// 클립보드가 비어있으면 아무일도 하지 않음
 		if (kboard_paste(&clipBoardValue) != 0)
 		{
+			emptyRetry++;
 			continue;
 		}
 
+		// 덮어쓰기 모드에서는 버려진 값만큼 건너뛸 수 있음
+		if (overwrite && clipBoardValue > expectValue)
+		{
+			missed += clipBoardValue - expectValue;
+			expectValue = clipBoardValue;
+		}
+
 		// 클립보드로 부터 받은 값이 예상되는 값과 다를 경우 동기화 문제 발생
 		if (clipBoardValue != expectValue)
 		{
@@ -33,6 +70,7 @@ int main()
 
 		// 다음에 받아야 할 값을 1 만큼 증가
 		expectValue++;
+		success++;
 	}
 
 	return 0;
@@ -0,0 +1,231 @@
+#define _GNU_SOURCE
+
+#include "KboardIoctl.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// /dev/kboard 의 ioctl 인터페이스를 사용하는 명령행 클라이언트
+// KboardCtl enqueue <value> | dequeue | sample [count] | status | splice in | splice out | peek [count] | filter min <value> | filter off
+// splice in 은 표준 입력 파이프의 __s32 값들을, splice out 은 꺼낸 값들을 표준 출력 파이프로 복사 없이 옮김
+//   예: ./gen | KboardCtl splice in, KboardCtl splice out | ./consume
+// peek 은 링 버퍼의 미러를 mmap 하여 시스템 콜 없이 무작위로 읽음
+// filter min <value> 는 value 보다 작은 값을 커널에서 버리는 필터를 붙이고 filter off 는 떼어냄 (관리자 권한 필요)
+
+// 미러에서 값이 들어있는 칸 하나를 무작위로 읽음, 비어 있으면 -1
+// Writer 가 바꾸는 중이었거나 읽는 사이 바뀌었으면 (Sequence 가 홀수이거나 달라짐) 다시 읽음
+static int Peek(const struct KboardShared *shared, int *index, int *item)
+{
+	__u32 sequence;
+	int capacity;
+	int count;
+	int slot;
+	int value;
+
+	while (1)
+	{
+		sequence = __atomic_load_n(&shared->Sequence, __ATOMIC_ACQUIRE);
+		if ((sequence & 1) != 0)
+		{
+			continue;
+		}
+
+		capacity = __atomic_load_n(&shared->Capacity, __ATOMIC_RELAXED);
+		count = __atomic_load_n(&shared->Count, __ATOMIC_RELAXED);
+		slot = __atomic_load_n(&shared->CurrentIndex, __ATOMIC_RELAXED);
+		value = -1;
+		// 바뀌는 중에 읽은 값은 범위를 벗어날 수 있으므로 검사한 뒤에만 칸을 읽음
+		if (capacity > 0 && capacity <= KBOARD_SHARED_CAPACITY_MAX && count > 0 && count <= capacity
+			&& slot >= 0 && slot < capacity)
+		{
+			slot = (slot + rand() % count) % capacity;
+			value = __atomic_load_n(&shared->Items[slot], __ATOMIC_RELAXED);
+		}
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&shared->Sequence, __ATOMIC_RELAXED) == sequence)
+		{
+			break;
+		}
+	}
+
+	if (count <= 0)
+	{
+		return -1;
+	}
+
+	*index = slot;
+	*item = value;
+
+	return 0;
+}
+
+// 가져온 만큼 from 에서 to 로 splice, 옮긴 바이트 수를 출력
+static int SpliceAll(int from, int to)
+{
+	ssize_t moved;
+	long long total = 0;
+
+	while ((moved = splice(from, NULL, to, NULL, 1 << 16, SPLICE_F_MOVE)) > 0)
+	{
+		total += moved;
+	}
+
+	fprintf(stderr, "Splice: '%lld' bytes, '%lld' items\n", total, total / (long long)sizeof(__s32));
+
+	return moved < 0 ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct KboardItem item;
+	struct KboardSample sample;
+	struct KboardSampleBatch sampleBatch;
+	struct KboardStatus status;
+	const struct KboardShared *shared;
+	int device;
+	int index;
+	int result = -1;
+
+	if (argc < 2)
+	{
+		printf("Usage: %s enqueue <value> | dequeue | sample [count] | status | splice in | splice out | peek [count] | filter min <value> | filter off\n", argv[0]);
+		return -1;
+	}
+
+	device = open("/dev/" KBOARD_DEVICE, O_RDWR);
+	if (device < 0)
+	{
+		printf("Failed to open /dev/%s: %s\n", KBOARD_DEVICE, strerror(errno));
+		return -1;
+	}
+
+	if (strcmp(argv[1], "enqueue") == 0 && argc > 2)
+	{
+		item.Item = atoi(argv[2]);
+		result = ioctl(device, KBOARD_IOC_ENQUEUE, &item);
+		if (result == 0)
+		{
+			printf("Enqueue: '%d'\n", item.Item);
+		}
+	}
+	else if (strcmp(argv[1], "dequeue") == 0)
+	{
+		result = ioctl(device, KBOARD_IOC_DEQUEUE, &item);
+		if (result == 0)
+		{
+			printf("Dequeue: '%d'\n", item.Item);
+		}
+	}
+	else if (strcmp(argv[1], "sample") == 0 && argc > 2)
+	{
+		sampleBatch.Count = atoi(argv[2]);
+		result = ioctl(device, KBOARD_IOC_SAMPLE_BATCH, &sampleBatch);
+		if (result == 0)
+		{
+			printf("Sample:");
+			for (index = 0; index < sampleBatch.Count; index++)
+			{
+				printf(" '%d'", sampleBatch.Items[index]);
+			}
+			printf("\n");
+		}
+	}
+	else if (strcmp(argv[1], "sample") == 0)
+	{
+		result = ioctl(device, KBOARD_IOC_SAMPLE, &sample);
+		if (result == 0)
+		{
+			printf("Sample: index: '%d', value: '%d'\n", sample.Index, sample.Item);
+		}
+	}
+	else if (strcmp(argv[1], "status") == 0)
+	{
+		result = ioctl(device, KBOARD_IOC_STATUS, &status);
+		if (result == 0)
+		{
+			printf("Count: '%d', Capacity: '%d', CurrentIndex: '%d', SyncSolution: '%d', Writer: '%llu', Reader: '%llu'\n",
+				status.Count, status.Capacity, status.CurrentIndex, status.SyncSolution,
+				(unsigned long long)status.PerformWriter, (unsigned long long)status.PerformReader);
+		}
+	}
+	else if (strcmp(argv[1], "splice") == 0 && argc > 2 && strcmp(argv[2], "in") == 0)
+	{
+		result = SpliceAll(STDIN_FILENO, device);
+	}
+	else if (strcmp(argv[1], "splice") == 0 && argc > 2 && strcmp(argv[2], "out") == 0)
+	{
+		result = SpliceAll(device, STDOUT_FILENO);
+	}
+	else if (strcmp(argv[1], "peek") == 0)
+	{
+		shared = mmap(NULL, sizeof(*shared), PROT_READ, MAP_SHARED, device, 0);
+		if (shared == MAP_FAILED)
+		{
+			printf("Failed to mmap /dev/%s: %s\n", KBOARD_DEVICE, strerror(errno));
+			close(device);
+			return -1;
+		}
+
+		srand(getpid());
+		for (index = 0; index < (argc > 2 ? atoi(argv[2]) : 1); index++)
+		{
+			if (Peek(shared, &sample.Index, &sample.Item) != 0)
+			{
+				printf("Peek: empty\n");
+				break;
+			}
+			printf("Peek: index: '%d', value: '%d'\n", sample.Index, sample.Item);
+		}
+		munmap((void *)shared, sizeof(*shared));
+		result = 0;
+	}
+	else if (strcmp(argv[1], "filter") == 0 && argc > 3 && strcmp(argv[2], "min") == 0)
+	{
+		// ld [Item]; jge #value, accept, drop; accept: ret a; drop: ret #0xffffffff
+		// 음수 값은 부호 없이 비교하면 커지지만 ret a 가 음수를 돌려주므로 함께 버려짐
+		struct sock_filter program[] =
+		{
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 0),
+			BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K, (__u32)atoi(argv[3]), 0, 1),
+			BPF_STMT(BPF_RET | BPF_A, 0),
+			BPF_STMT(BPF_RET | BPF_K, (__u32)-1),
+		};
+		struct sock_fprog filter = { sizeof(program) / sizeof(program[0]), program };
+
+		result = ioctl(device, KBOARD_IOC_SET_FILTER, &filter);
+		if (result == 0)
+		{
+			printf("Filter: drop below '%d'\n", atoi(argv[3]));
+		}
+	}
+	else if (strcmp(argv[1], "filter") == 0 && argc > 2 && strcmp(argv[2], "off") == 0)
+	{
+		result = ioctl(device, KBOARD_IOC_SET_FILTER, NULL);
+		if (result == 0)
+		{
+			printf("Filter: off\n");
+		}
+	}
+	else
+	{
+		printf("Unknown command: '%s'\n", argv[1]);
+		close(device);
+		return -1;
+	}
+
+	if (result != 0)
+	{
+		printf("Failed %s: %s\n", argv[1], strerror(errno));
+	}
+
+	close(device);
+
+	return result;
+}
@@ -0,0 +1,91 @@
+#ifndef KBOARD_IOCTL_H
+#define KBOARD_IOCTL_H
+
+// /dev/kboard 의 ioctl 인터페이스, 커널 모듈과 유저 프로그램이 함께 사용
+// 모든 명령은 성공하면 0, 실패하면 -1 을 반환하고 errno 에 오류 코드를 설정
+//   EINVAL: 음수 값 또는 잘못된 개수, ENOSPC: 링 버퍼가 가득 참, ENODATA: 링 버퍼가 비어 있음, EFAULT: 잘못된 주소
+// read, write 는 __s32 값의 배열을 Dequeue, Enqueue 하고 처리한 바이트 수를 반환, 비어 있으면 read 는 0
+// splice 로 파이프와 직접 주고받을 수 있음
+// KBOARD_IOC_SET_FILTER 는 모든 Enqueue 경로에 classic BPF 필터를 붙임 (../lab1/kernel/kboard_filter.h), 인자가 NULL 이면 떼어냄
+//   필터가 버린 값은 넣은 것으로 처리, 필터가 있으면 음수 값 검사 대신 필터가 판단, CAP_SYS_ADMIN 이 없으면 EPERM
+
+#include <linux/filter.h>
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+#define KBOARD_DEVICE "kboard"
+#define KBOARD_IOCTL_MAGIC 'k'
+
+// Enqueue, Dequeue 할 값
+struct KboardItem
+{
+    __s32 Item;
+};
+
+// 무작위로 읽은 칸의 위치와 값
+struct KboardSample
+{
+    __s32 Index;
+    __s32 Item;
+};
+
+// 한 번에 무작위로 읽을 수 있는 최대 개수
+#define KBOARD_SAMPLE_MAX 256
+
+// 값이 들어있는 칸들에서 복원 추출한 값들, Count에 요청할 개수를 넣으면 읽은 개수로 바뀜
+struct KboardSampleBatch
+{
+    __s32 Count;
+    __s32 Items[KBOARD_SAMPLE_MAX];
+};
+
+// Kboard 상태
+struct KboardStatus
+{
+    __s32 Count;
+    __s32 Capacity;
+    __s32 CurrentIndex;
+    __s32 SyncSolution;
+    __u64 PerformWriter;
+    __u64 PerformReader;
+};
+
+// /proc/kboard/snapshot 의 형식, 헤더 뒤에 Capacity 개의 __s32 칸 값이 이어짐
+#define KBOARD_SNAPSHOT_MAGIC 0x4B425244
+#define KBOARD_SNAPSHOT_VERSION 1
+
+struct KboardSnapshotHeader
+{
+    __u32 Magic;
+    __u32 Version;
+    __s32 Capacity;
+    __s32 Count;
+    __s32 CurrentIndex;
+    __s32 SyncSolution;
+    __u64 PerformWriter;
+    __u64 PerformReader;
+};
+
+// mmap 으로 공유하는 링 버퍼의 읽기 전용 미러, /dev/kboard 를 PROT_READ 로 sizeof(struct KboardShared) 만큼 매핑
+// Items[i] 는 링 버퍼의 i 번째 칸, 앞에서 offset 번째 값은 Items[(CurrentIndex + offset) % Capacity]
+// Sequence 가 홀수이면 값을 바꾸는 중, 읽기 전후의 Sequence 가 같은 짝수일 때만 읽은 값이 유효하므로 아니면 다시 읽음
+// 미러는 용량과 관계없이 이 크기(4 MiB)로 한 번만 할당
+#define KBOARD_SHARED_CAPACITY_MAX (1 << 20)
+
+struct KboardShared
+{
+    __u32 Sequence;
+    __s32 Capacity;
+    __s32 Count;
+    __s32 CurrentIndex;
+    __s32 Items[KBOARD_SHARED_CAPACITY_MAX];
+};
+
+#define KBOARD_IOC_ENQUEUE _IOW(KBOARD_IOCTL_MAGIC, 1, struct KboardItem)
+#define KBOARD_IOC_DEQUEUE _IOR(KBOARD_IOCTL_MAGIC, 2, struct KboardItem)
+#define KBOARD_IOC_SAMPLE _IOR(KBOARD_IOCTL_MAGIC, 3, struct KboardSample)
+#define KBOARD_IOC_STATUS _IOR(KBOARD_IOCTL_MAGIC, 4, struct KboardStatus)
+#define KBOARD_IOC_SAMPLE_BATCH _IOWR(KBOARD_IOCTL_MAGIC, 5, struct KboardSampleBatch)
+#define KBOARD_IOC_SET_FILTER _IOW(KBOARD_IOCTL_MAGIC, 6, struct sock_fprog)
+
+#endif
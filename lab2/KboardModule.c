@@ -1,13 +1,36 @@
+#include <linux/capability.h>
+#include <linux/compat.h>
+#include <linux/ctype.h>
 #include <linux/delay.h>
+#include <linux/hash.h>
+#include <linux/ktime.h>
 #include <linux/list.h>
+#include <linux/mm.h>
+#include <linux/miscdevice.h>
 #include <linux/module.h>
+#include <linux/moduleparam.h>
 #include <linux/mutex.h>
+#include <linux/percpu.h>
 #include <linux/proc_fs.h>
 #include <linux/random.h>
+#include <linux/rcupdate.h>
+#include <linux/refcount.h>
+#include <linux/rhashtable.h>
+#include <linux/sched.h>
 #include <linux/seq_file.h>
+#include <linux/shrinker.h>
 #include <linux/spinlock.h>
 #include <linux/slab.h>
 #include <linux/uaccess.h>
+#include <linux/uio.h>
+#include <linux/vmalloc.h>
+#include <linux/workqueue.h>
+#include <net/genetlink.h>
+
+#include "KboardIoctl.h"
+#include "KboardNetlink.h"
+#include "../lab1/kernel/kboard_filter.h"
+#include "../lab1/kernel/kboard_ring_generic.h"
 
 // 사용할 Readers-Writers Problem 솔루션 종류 1 ~ 3
 #define SYNC_SOLUTION 1
@@ -18,11 +41,38 @@
 #define KBOARD_READER "reader"
 #define KBOARD_COUNTER "count"
 #define KBOARD_DUMPER "dump"
+#define KBOARD_WAITS "waits"
+#define KBOARD_DRAIN "drain"
+#define KBOARD_SAMPLER "sampler"
+#define KBOARD_SNAPSHOT "snapshot"
+#define KBOARD_CAPACITY "capacity"
 
 // Kboard 서비스
 #define RING_BUFFER_SIZE 5
+#define RING_CAPACITY_MAX KBOARD_SHARED_CAPACITY_MAX
+#define SAMPLER_MAX KBOARD_SAMPLE_MAX
 #define RING_BUFFER_INIT_VALUE -1
-#define WRITER_BUFFER_SIZE 20
+#define WRITER_BUFFER_SIZE (1 << 20)
+#define DEVICE_IO_BATCH 256
+
+// Critical Section 진입 대기 시간 측정
+#define WAIT_ROLE_WRITER 0
+#define WAIT_ROLE_READER 1
+#define WAIT_ROLE_COUNT 2
+#define WAIT_HISTOGRAM_SIZE 64
+#define WAIT_TASK_BITS 8
+#define WAIT_TASK_MAX (1 << WAIT_TASK_BITS)
+
+// 링 버퍼가 가득 찼을 때 넘치는 값을 보관하는 백로그, 메모리 부족 시 Shrinker 가 정책에 따라 버림
+#define BACKLOG_CHUNK_ITEMS 1000
+#define SHRINK_POLICY_NONE 0
+#define SHRINK_POLICY_OLDEST 1
+#define SHRINK_POLICY_NEWEST 2
+
+// 새로 들어온 값을 모아 Generic Netlink로 알릴 때 한 메시지에 담을 최대 개수
+#define NOTIFY_BATCH_MAX 1024
+
+struct KboardRing;
 
 static inline void InitializeSemaphore(struct semaphore *sema, int value);
 
@@ -30,8 +80,51 @@ static inline void InitializeSemaphore(struct semaphore *sema, int value);
 static int InitializeProc(void);
 static void DestroyProc(void);
 
-// Kboard 서비스 초기화
-static void InitializeKboard(void);
+// Kboard 장치 생성 삭제
+static int InitializeDevice(void);
+static void DestroyDevice(void);
+
+// Kboard 서비스 초기화, 삭제
+static int InitializeKboard(void);
+static void DestroyKboard(void);
+
+// Kboard 서비스 연산, 성공하면 0, 실패하면 음수 오류 코드를 반환
+static int KboardEnqueue(int item);
+static int KboardEnqueueBatch(const int *items, int count);
+static int KboardDequeue(int *item);
+static int KboardDequeueBatch(int *items, int count);
+static int KboardEnqueueIter(struct iov_iter *from, int count, int *error);
+static int KboardDequeueIter(struct iov_iter *to, int count, int *error);
+
+// 링 버퍼 변경, 변경마다 mmap 미러에도 반영
+static int RingPush(struct KboardRing *ring, int item, gfp_t gfp);
+static int RingPop(struct KboardRing *ring);
+static void RingRefill(struct KboardRing *ring);
+static void SharedSync(struct KboardRing *ring, int clear);
+static int KboardSample(unsigned int *index, int *item);
+static int KboardSampleBatch(int *items, unsigned int *indexes, int count);
+static struct KboardSnapshot *TakeSnapshot(size_t *size);
+static int KboardResize(int newCapacity);
+static int KboardCount(void);
+
+// 백로그 연산, BacklogPeek와 BacklogTake는 BacklogLock을 잡은 상태에서 호출
+static int BacklogPush(int item);
+static int BacklogPeek(void);
+static int BacklogTake(bool oldest);
+static void DestroyBacklog(void);
+
+// 중복 제거 저장소 연산, Writer Critical Section 안에서 호출
+static struct KboardPayload *PayloadGet(int value, gfp_t gfp);
+static void PayloadPut(struct KboardPayload *payload);
+static void KboardPayload_Free(void *object, void *argument);
+
+// 새로 들어온 값의 Generic Netlink 알림
+static void NotifyClips(const int *items, int count);
+static void KboardNotify_Work(struct work_struct * work);
+
+// 메모리 부족 시 백로그를 회수하는 Shrinker
+static unsigned long KboardShrinker_Count(struct shrinker * shrinker, struct shrink_control * control);
+static unsigned long KboardShrinker_Scan(struct shrinker * shrinker, struct shrink_control * control);
 
 // Readers-Writers Problem 솔루션 관련 메서드
 static void InitializeSyncSolution(void);
@@ -40,16 +133,55 @@ static void EnterCriticalSection_Reader(void);
 static void LeaveCriticalSection_Writer(void);
 static void LeaveCriticalSection_Reader(void);
 
+// 대기 시간을 기록하면서 Critical Section에 진입
+static void RecordWait(int role, u64 waitNs);
+static void EnterWriter(void);
+static void EnterReader(void);
+static void ResetWaitStat(void);
+
 // ProcFS 관련 메서드
 static int KboardWriter_Open(struct inode * inode, struct file * file);
 static int KboardWriter_Show(struct seq_file * file, void * unused);
 static ssize_t KboardWriter_Write(struct file * file, const char __user * data, size_t length, loff_t * off);
+static int KboardWriter_Release(struct inode * inode, struct file * file);
 static int KboardReader_Open(struct inode * inode, struct file * file);
 static int KboardReader_Show(struct seq_file * file, void * unused);
 static int KboardCounter_Open(struct inode * inode, struct file * file);
 static int KboardCounter_Show(struct seq_file * file, void * unused);
 static int KboardDumper_Open(struct inode * inode, struct file * file);
-static int KboardDumper_Show(struct seq_file * file, void * unused);
+static void *KboardDumper_Start(struct seq_file * file, loff_t * position);
+static void *KboardDumper_Next(struct seq_file * file, void * value, loff_t * position);
+static void KboardDumper_Stop(struct seq_file * file, void * value);
+static int KboardDumper_Show(struct seq_file * file, void * value);
+static int KboardDumper_Release(struct inode * inode, struct file * file);
+static int KboardWaits_Open(struct inode * inode, struct file * file);
+static int KboardWaits_Show(struct seq_file * file, void * unused);
+static ssize_t KboardWaits_Write(struct file * file, const char __user * data, size_t length, loff_t * off);
+static int KboardBatch_Open(struct file * file, int (*show)(struct seq_file *, void *), int limit);
+static ssize_t KboardBatch_Read(struct file * file, char __user * data, size_t length, loff_t * off);
+static ssize_t KboardBatch_Write(struct file * file, const char __user * data, size_t length, loff_t * off);
+static int KboardBatch_Release(struct inode * inode, struct file * file);
+static void KboardBatch_Print(struct seq_file * file);
+static int KboardDrain_Open(struct inode * inode, struct file * file);
+static int KboardDrain_Show(struct seq_file * file, void * unused);
+static int KboardSampler_Open(struct inode * inode, struct file * file);
+static int KboardSampler_Show(struct seq_file * file, void * unused);
+static int KboardSnapshot_Open(struct inode * inode, struct file * file);
+static ssize_t KboardSnapshot_Read(struct file * file, char __user * data, size_t length, loff_t * off);
+static int KboardSnapshot_Release(struct inode * inode, struct file * file);
+static int KboardCapacity_Open(struct inode * inode, struct file * file);
+static int KboardCapacity_Show(struct seq_file * file, void * unused);
+static ssize_t KboardCapacity_Write(struct file * file, const char __user * data, size_t length, loff_t * off);
+
+// 장치 관련 메서드
+static long KboardDevice_Ioctl(struct file * file, unsigned int command, unsigned long argument);
+#ifdef CONFIG_COMPAT
+static long KboardDevice_CompatIoctl(struct file * file, unsigned int command, unsigned long argument);
+#endif
+static long KboardDevice_SampleBatch(struct KboardSampleBatch __user *userBatch);
+static ssize_t KboardDevice_ReadIter(struct kiocb * iocb, struct iov_iter * to);
+static ssize_t KboardDevice_WriteIter(struct kiocb * iocb, struct iov_iter * from);
+static int KboardDevice_Mmap(struct file * file, struct vm_area_struct * vma);
 
 // 모듈
 static int __init KboardModuleInit(void);
@@ -63,7 +195,7 @@ static const struct file_operations KBOARD_WRITER_FILE_OPERATIONS =
     .write      = KboardWriter_Write,
     .read       = seq_read,
     .llseek     = seq_lseek,
-    .release    = seq_release,
+    .release    = KboardWriter_Release,
 };
 static const struct file_operations KBOARD_READER_FILE_OPERATIONS =
 {
@@ -87,8 +219,76 @@ static const struct file_operations KBOARD_DUMPER_FILE_OPERATIONS =
     .open       = KboardDumper_Open,
     .read       = seq_read,
     .llseek     = seq_lseek,
+    .release    = KboardDumper_Release,
+};
+static const struct file_operations KBOARD_WAITS_FILE_OPERATIONS =
+{
+    .owner      = THIS_MODULE,
+    .open       = KboardWaits_Open,
+    .write      = KboardWaits_Write,
+    .read       = seq_read,
+    .llseek     = seq_lseek,
     .release    = seq_release,
 };
+static const struct file_operations KBOARD_DRAIN_FILE_OPERATIONS =
+{
+    .owner      = THIS_MODULE,
+    .open       = KboardDrain_Open,
+    .write      = KboardBatch_Write,
+    .read       = KboardBatch_Read,
+    .llseek     = seq_lseek,
+    .release    = KboardBatch_Release,
+};
+static const struct file_operations KBOARD_SAMPLER_FILE_OPERATIONS =
+{
+    .owner      = THIS_MODULE,
+    .open       = KboardSampler_Open,
+    .write      = KboardBatch_Write,
+    .read       = KboardBatch_Read,
+    .llseek     = seq_lseek,
+    .release    = KboardBatch_Release,
+};
+static const struct file_operations KBOARD_SNAPSHOT_FILE_OPERATIONS =
+{
+    .owner      = THIS_MODULE,
+    .open       = KboardSnapshot_Open,
+    .read       = KboardSnapshot_Read,
+    .llseek     = default_llseek,
+    .release    = KboardSnapshot_Release,
+};
+static const struct file_operations KBOARD_CAPACITY_FILE_OPERATIONS =
+{
+    .owner      = THIS_MODULE,
+    .open       = KboardCapacity_Open,
+    .write      = KboardCapacity_Write,
+    .read       = seq_read,
+    .llseek     = seq_lseek,
+    .release    = single_release,
+};
+
+static const struct file_operations KBOARD_DEVICE_FILE_OPERATIONS =
+{
+    .owner          = THIS_MODULE,
+    .read_iter      = KboardDevice_ReadIter,
+    .write_iter     = KboardDevice_WriteIter,
+    .splice_read    = generic_file_splice_read,
+    .splice_write   = iter_file_splice_write,
+    .llseek         = no_llseek,
+    .mmap           = KboardDevice_Mmap,
+    .unlocked_ioctl = KboardDevice_Ioctl,
+#ifdef CONFIG_COMPAT
+    .compat_ioctl   = KboardDevice_CompatIoctl,
+#endif
+};
+
+static struct miscdevice KboardDevice =
+{
+    .minor  = MISC_DYNAMIC_MINOR,
+    .name   = KBOARD_DEVICE,
+    .fops   = &KBOARD_DEVICE_FILE_OPERATIONS,
+    // /proc/kboard 파일들처럼 관리자만 값을 바꿀 수 있도록 소유자만 읽고 씀
+    .mode   = 0600,
+};
 
 static struct proc_dir_entry *ParentDirectory = NULL;
 static struct proc_dir_entry *KboardProcDirectory = NULL;
@@ -96,40 +296,231 @@ static struct proc_dir_entry *KboardProcWriter = NULL;
 static struct proc_dir_entry *KboardProcReader = NULL;
 static struct proc_dir_entry *KboardProcCounter = NULL;
 static struct proc_dir_entry *KboardProcDumper = NULL;
+static struct proc_dir_entry *KboardProcWaits = NULL;
+static struct proc_dir_entry *KboardProcDrain = NULL;
+static struct proc_dir_entry *KboardProcSampler = NULL;
+static struct proc_dir_entry *KboardProcSnapshot = NULL;
+static struct proc_dir_entry *KboardProcCapacity = NULL;
 
-// Readers-Writers Problem 솔루션에서 사용할 솔루션 종류별 변수들
-#if SYNC_SOLUTION == 1
-static struct semaphore SemaphoreMutex;
-static struct semaphore SemaphoreWriter;
-static int ReaderCount;
-
-#elif SYNC_SOLUTION == 2
-static struct semaphore SemaphoreWriterMutex;
-static struct semaphore SemaphoreReaderMutex;
-static struct semaphore SemaphoreWriter;
-static struct semaphore SemaphoreReader;
-static int WriterCount;
-static int ReaderCount;
-
-#elif SYNC_SOLUTION == 3
-static struct semaphore SemaphoreMutex;
-static struct semaphore SemaphoreWriter;
-static struct semaphore SemaphoreReader;
-static int WriterCount;
-static int ReaderCount;
-static int WriterWaitingCount;
-static int ReaderWaitingCount;
-#endif
+// Readers-Writers Problem 솔루션, 유저 공간 시뮬레이터(sim/)와 공유
+#include "KboardSync.h"
 
 // Kboard 서비스 관련 변수
-static int RingBuffer[RING_BUFFER_SIZE];
-static int RingBufferCount;
-static int RingBufferCurrentIndex;
+// 링 버퍼의 한 칸, 중복 제거를 사용하지 않으면 값을, 사용하면 저장소의 값에 대한 참조만 저장
+// 빈 칸인지는 Count로 판단하므로 빈 칸의 내용은 읽지 않음
+union KboardSlot
+{
+    int Item;
+    struct KboardPayload *Payload;
+};
+
+#define RING_BUFFER_EMPTY_SLOT ((union KboardSlot) { .Payload = NULL })
+
+// 링 버퍼는 os_kboard.c와 같은 구현을 실행 중에 용량을 정하도록 특수화, 동기화는 Readers-Writers 솔루션이 담당
+KB_RING_DEFINE_DYNAMIC(KboardRing, union KboardSlot, RING_BUFFER_EMPTY_SLOT, NONE)
+
+// 용량을 바꾸면 새 링 버퍼로 교체되므로 RCU로 보호
+// Writer Critical Section과 ResizeLock 안에서는 CurrentRing()으로, 그 밖에서는 rcu_read_lock() 안에서 읽음
+static struct KboardRing __rcu *RingBuffer;
+
+// mmap으로 Reader에게 읽기 전용으로 공유하는 링 버퍼의 미러, 용량을 바꿔도 다시 매핑하지 않도록 최대 용량으로 할당
+// 값을 바꾸는 쪽은 Writer Critical Section 또는 용량 변경 하나뿐이므로 Sequence는 잠금 없이 seqcount처럼 갱신
+static struct KboardShared *Shared;
+
+// 용량 변경끼리, 그리고 용량에 맞춰 복사본을 만드는 TakeSnapshot()과 직렬화
+static DEFINE_MUTEX(ResizeLock);
+
+// Enqueue 경로의 BPF 필터, Enqueue는 RCU 안에서 실행하고 바꾸는 쪽은 FilterLock으로 직렬화
+static struct bpf_prog __rcu *Filter;
+static DEFINE_MUTEX(FilterLock);
+
+// 링 버퍼 용량, 모듈을 올릴 때 정하고 실행 중에는 /proc/kboard/capacity에 써서 변경
+// 2의 거듭제곱이면 인덱스를 나눗셈 없이 마스크로 감음
+static int capacity = RING_BUFFER_SIZE;
+module_param(capacity, int, 0444);
+MODULE_PARM_DESC(capacity, "Ring buffer capacity, resized at runtime through /proc/kboard/capacity");
 
 // Writer, Reader 수행 횟수, 수행 시간 변수
 static int PerformWriter;
 static int PerformReader;
-static int PerformDelay;
+
+// 백로그 최대 개수, 0이면 백로그를 사용하지 않고 링 버퍼가 가득 차면 실패
+static int backlog_max = 0;
+module_param(backlog_max, int, 0644);
+MODULE_PARM_DESC(backlog_max, "Maximum number of clips kept beyond the ring buffer (0 disables the backlog)");
+
+// 메모리 부족 시 백로그에서 버릴 값, 0: 버리지 않음, 1: 가장 오래된 값, 2: 가장 최근 값
+static int shrink_policy = SHRINK_POLICY_NONE;
+module_param(shrink_policy, int, 0644);
+MODULE_PARM_DESC(shrink_policy, "Clips dropped under memory pressure: 0 none, 1 oldest, 2 newest");
+
+// 백로그는 페이지 크기 정도의 덩어리를 목록으로 연결하여 보관
+// 링 버퍼가 가득 찼거나 백로그가 비어 있지 않으면 백로그 뒤에 넣으므로 링 버퍼 -> 백로그 순서가 곧 들어온 순서
+// 덩어리는 값을 넣는 Task의 memcg에 청구되도록 GFP_KERNEL_ACCOUNT로 할당
+// Writer Critical Section과 별개로 BacklogLock으로 보호하여 Shrinker가 세마포어를 기다리지 않음
+struct KboardBacklogChunk
+{
+    struct list_head List;
+    int Head;   // 가장 오래된 값의 위치
+    int Tail;   // 다음 값을 넣을 위치
+    int Items[BACKLOG_CHUNK_ITEMS];
+};
+
+static DEFINE_SPINLOCK(BacklogLock);
+static LIST_HEAD(Backlog);
+static int BacklogCount;
+static int BacklogChunks;
+static u64 BacklogDropped;
+
+static struct shrinker KboardShrinker =
+{
+    .count_objects  = KboardShrinker_Count,
+    .scan_objects   = KboardShrinker_Scan,
+    .seeks          = DEFAULT_SEEKS,
+};
+
+// 링 버퍼의 각 칸이 중복 제거 저장소의 값을 참조, 모듈을 올릴 때만 설정
+static bool dedup = false;
+module_param(dedup, bool, 0444);
+MODULE_PARM_DESC(dedup, "Share one reference-counted payload between ring slots holding the same value");
+
+// 중복 제거 저장소의 값, 같은 값을 가진 칸들이 하나를 공유
+// 값은 int이므로 칸마다 int 대신 포인터를 두고 값마다 이 구조체와 해시 버킷을 더 쓰게 되어 메모리는 오히려 늘어남
+// 조회는 RCU 안에서 잠금 없이 하고 참조 횟수가 0이 된 값은 지운 뒤 RCU 유예 기간이 지나면 해제
+struct KboardPayload
+{
+    int Value;
+    refcount_t Reference;
+    struct rhash_head Node;
+    struct rcu_head Rcu;
+};
+
+static const struct rhashtable_params PAYLOAD_TABLE_PARAMS =
+{
+    .key_len                = sizeof(int),
+    .key_offset             = offsetof(struct KboardPayload, Value),
+    .head_offset            = offsetof(struct KboardPayload, Node),
+    .automatic_shrinking    = true,
+};
+
+static struct rhashtable PayloadTable;
+
+// 중복 제거 통계, Writer Critical Section 안에서 갱신
+static u64 DedupLookups;
+static u64 DedupHits;
+static u64 DedupReferences;
+static u64 DedupStoreBytes;     // 저장소 값들의 실제 할당 크기 (ksize) 합
+
+// 새로 들어온 값을 모으는 시간 (us), 0이면 들어올 때마다 바로 알림
+static int notify_window_us = 1000;
+module_param(notify_window_us, int, 0644);
+MODULE_PARM_DESC(notify_window_us, "Time new clips are collected before one netlink notification is multicast (0 sends immediately)");
+
+static const struct genl_multicast_group KBOARD_GENL_GROUPS[] =
+{
+    { .name = KBOARD_GENL_GROUP },
+};
+
+static struct genl_family KboardFamily __ro_after_init =
+{
+    .name       = KBOARD_GENL_NAME,
+    .version    = KBOARD_GENL_VERSION,
+    .maxattr    = KBOARD_ATTR_MAX,
+    .module     = THIS_MODULE,
+    .mcgrps     = KBOARD_GENL_GROUPS,
+    .n_mcgrps   = ARRAY_SIZE(KBOARD_GENL_GROUPS),
+};
+
+// 알릴 값들, Writer Critical Section 안에서 들어온 순서대로 쌓고 KboardNotify_Work가 한 번에 보냄
+// 작업은 프로세스 문맥에서 실행되므로 NotifyLock은 Writer와 작업 사이에서만 잡음
+static DEFINE_SPINLOCK(NotifyLock);
+static int NotifyItems[NOTIFY_BATCH_MAX];
+static int NotifyCount;
+static u32 NotifyDropped;
+static DECLARE_DELAYED_WORK(NotifyWork, KboardNotify_Work);
+
+// Writer를 연 파일마다 가지는 상태, 마지막 Write()에서 넣은 개수를 다음 Read에서 한 번 보여줌
+// seq_file의 lock 안에서 변경
+struct KboardWriterResult
+{
+    bool Pending;   // 아직 Read로 보여주지 않은 Write() 결과가 있음
+    int Accepted;   // 넣은 값의 개수, 필터가 버린 값 포함
+    int Count;      // Write()에 들어 있던 값의 개수
+};
+
+// Writer: Write()에서 해석한 값마다 입력에서의 위치
+struct KboardWriterToken
+{
+    size_t End;     // 값이 끝나는 바이트 위치, 일부만 넣었을 때 반환
+    int Parsed;     // 이 값까지 해석한 토큰 수, 필터가 버린 값 포함
+};
+
+// Drain, Sampler를 연 파일마다 가지는 상태, 한 번의 Read에서 가져온 값들을 보관
+struct KboardBatch
+{
+    int Limit;      // 한 번에 가져올 최대 개수, Write()로 변경
+    int Count;      // 가져온 값의 개수
+    bool Done;      // seq_file이 버퍼를 늘려 Show를 다시 호출해도 다시 가져오지 않도록 표시
+    int *Items;     // Done, Items는 seq_file의 lock 안에서 변경
+};
+
+// 표본 추출에 사용할 CPU별 의사 난수 상태
+static DEFINE_PER_CPU(struct rnd_state, SampleRandomState);
+
+// 역할별 대기 시간 분포, 히스토그램의 i 번째 칸은 [2^i, 2^(i+1)) ns 대기 횟수
+struct WaitStat
+{
+    u64 Count;
+    u64 TotalNs;
+    u64 MaxNs;
+    u64 Histogram[WAIT_HISTOGRAM_SIZE];
+};
+
+// Task, 역할별 대기 시간 합계
+struct WaitTaskStat
+{
+    pid_t Pid;
+    int Role;
+    u64 Count;
+    u64 TotalNs;
+    u64 MaxNs;
+};
+
+// CPU별 측정값, Critical Section에 진입하는 경로는 자기 CPU의 값만 갱신하므로 다른 CPU와 잠금을 다투지 않음
+// Lock은 측정값을 모아 출력하거나 초기화할 때만 다른 CPU에서 잡음
+// 같은 Task가 여러 CPU에서 기록되면 출력할 때 (pid, role)별로 합침
+struct WaitCpuStat
+{
+    spinlock_t Lock;
+    struct WaitStat Roles[WAIT_ROLE_COUNT];
+    struct WaitTaskStat Tasks[WAIT_TASK_MAX];
+    int TaskCount;
+    u64 TaskOverflow;
+};
+
+static struct WaitCpuStat __percpu *WaitCpuStats;
+
+// Dumper, Snapshot을 연 시점의 링 버퍼 복사본, /proc/kboard/snapshot의 형식 그대로 보관
+struct KboardSnapshot
+{
+    struct KboardSnapshotHeader Header;
+    int Items[];
+};
+
+// Dumper의 seq_file 반복자 위치: 0은 머리말, 1 ~ Capacity는 각 칸, Capacity + 1은 꼬리말
+static const struct seq_operations KBOARD_DUMPER_SEQ_OPERATIONS =
+{
+    .start  = KboardDumper_Start,
+    .next   = KboardDumper_Next,
+    .stop   = KboardDumper_Stop,
+    .show   = KboardDumper_Show,
+};
+
+// Writer Critical Section 또는 ResizeLock 안에서 현재 링 버퍼, 그동안은 교체되지 않음
+static inline struct KboardRing *CurrentRing(void)
+{
+    return rcu_dereference_protected(RingBuffer, true);
+}
 
 // 세마포어 초기화
 static inline void InitializeSemaphore(struct semaphore *sema, int value)
@@ -186,10 +577,60 @@ static int InitializeProc(void)
         return -1;
     }
 
+    // Waits
+    KboardProcWaits = proc_create(KBOARD_WAITS, 0, KboardProcDirectory, &KBOARD_WAITS_FILE_OPERATIONS);
+    if (KboardProcWaits == NULL)
+    {
+        printk("Failed to create /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_WAITS);
+        remove_proc_entry(KBOARD_DIRECTORY, ParentDirectory);
+        return -1;
+    }
+
+    // Drain
+    KboardProcDrain = proc_create(KBOARD_DRAIN, 0, KboardProcDirectory, &KBOARD_DRAIN_FILE_OPERATIONS);
+    if (KboardProcDrain == NULL)
+    {
+        printk("Failed to create /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_DRAIN);
+        remove_proc_entry(KBOARD_DIRECTORY, ParentDirectory);
+        return -1;
+    }
+
+    // Sampler
+    KboardProcSampler = proc_create(KBOARD_SAMPLER, 0, KboardProcDirectory, &KBOARD_SAMPLER_FILE_OPERATIONS);
+    if (KboardProcSampler == NULL)
+    {
+        printk("Failed to create /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SAMPLER);
+        remove_proc_entry(KBOARD_DIRECTORY, ParentDirectory);
+        return -1;
+    }
+
+    // Snapshot
+    KboardProcSnapshot = proc_create(KBOARD_SNAPSHOT, 0, KboardProcDirectory, &KBOARD_SNAPSHOT_FILE_OPERATIONS);
+    if (KboardProcSnapshot == NULL)
+    {
+        printk("Failed to create /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SNAPSHOT);
+        remove_proc_entry(KBOARD_DIRECTORY, ParentDirectory);
+        return -1;
+    }
+
+    // Capacity
+    KboardProcCapacity = proc_create(KBOARD_CAPACITY, 0, KboardProcDirectory, &KBOARD_CAPACITY_FILE_OPERATIONS);
+    if (KboardProcCapacity == NULL)
+    {
+        printk("Failed to create /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_CAPACITY);
+        remove_proc_entry(KBOARD_DIRECTORY, ParentDirectory);
+        return -1;
+    }
+
     printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_WRITER);
     printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_READER);
     printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_COUNTER);
     printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_DUMPER);
+    printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_WAITS);
+    printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_DRAIN);
+    printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SAMPLER);
+    printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SNAPSHOT);
+    printk(KERN_DEBUG "Created /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_CAPACITY);
 
     return 0;
 }
@@ -205,377 +646,2004 @@ static void DestroyProc(void)
     proc_remove(KboardProcReader);
     proc_remove(KboardProcCounter);
     proc_remove(KboardProcDumper);
+    proc_remove(KboardProcWaits);
+    proc_remove(KboardProcDrain);
+    proc_remove(KboardProcSampler);
+    proc_remove(KboardProcSnapshot);
+    proc_remove(KboardProcCapacity);
 
     printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_WRITER);
     printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_READER);
     printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_COUNTER);
     printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_DUMPER);
+    printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_WAITS);
+    printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_DRAIN);
+    printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SAMPLER);
+    printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_SNAPSHOT);
+    printk(KERN_DEBUG "Removed /proc/%s/%s\n", KBOARD_DIRECTORY, KBOARD_CAPACITY);
 }
 
-// Kboard 서비스 초기화
-static void InitializeKboard(void)
+// /dev/kboard 생성
+static int InitializeDevice(void)
 {
-    int index;
+    if (misc_register(&KboardDevice) != 0)
+    {
+        printk("Failed to create /dev/%s\n", KBOARD_DEVICE);
+        return -1;
+    }
+
+    printk(KERN_DEBUG "Created /dev/%s\n", KBOARD_DEVICE);
+
+    return 0;
+}
+
+// /dev/kboard 삭제
+static void DestroyDevice(void)
+{
+    misc_deregister(&KboardDevice);
+
+    printk(KERN_DEBUG "Removed /dev/%s\n", KBOARD_DEVICE);
+}
+
+// Kboard 서비스 초기화, 용량이 범위를 벗어나면 -EINVAL, 링 버퍼 할당에 실패하면 -ENOMEM
+static int InitializeKboard(void)
+{
+    struct KboardRing *ring;
+    int cpu;
+
+    if (capacity <= 0 || capacity > RING_CAPACITY_MAX)
+    {
+        printk("%s: Capacity must be in 1 ~ %d, capacity: '%d'\n", __func__, RING_CAPACITY_MAX, capacity);
+        return -EINVAL;
+    }
 
     // Kboard 초기화
-    for (index = 0; index < RING_BUFFER_SIZE; index++)
+    ring = kvmalloc(KboardRing_size(capacity), GFP_KERNEL);
+    if (ring == NULL)
+    {
+        return -ENOMEM;
+    }
+    KboardRing_init(ring, capacity);
+    RCU_INIT_POINTER(RingBuffer, ring);
+
+    // mmap 미러, vmalloc_user는 0으로 채워진 페이지를 주므로 Sequence는 0에서 시작
+    Shared = vmalloc_user(sizeof(*Shared));
+    if (Shared == NULL)
     {
-        RingBuffer[index] = RING_BUFFER_INIT_VALUE;
+        kvfree(ring);
+        RCU_INIT_POINTER(RingBuffer, NULL);
+        return -ENOMEM;
+    }
+    SharedSync(ring, 0);
+
+    // CPU별 표본 추출 난수 상태 초기화
+    for_each_possible_cpu(cpu)
+    {
+        prandom_seed_state(per_cpu_ptr(&SampleRandomState, cpu), get_random_u64());
+    }
+
+    // CPU별 대기 시간 측정값, 크기가 커서 모듈의 정적 CPU별 영역 대신 동적으로 할당
+    WaitCpuStats = alloc_percpu(struct WaitCpuStat);
+    if (WaitCpuStats == NULL)
+    {
+        vfree(Shared);
+        Shared = NULL;
+        kvfree(ring);
+        RCU_INIT_POINTER(RingBuffer, NULL);
+        return -ENOMEM;
+    }
+    for_each_possible_cpu(cpu)
+    {
+        spin_lock_init(&per_cpu_ptr(WaitCpuStats, cpu)->Lock);
     }
-    RingBufferCount = 0;
-    RingBufferCurrentIndex = 0;
     
     // Writer, Reader 수행 횟수 초기화
     PerformWriter = 0;
     PerformReader = 0;
+
+    ResetWaitStat();
+
+    return 0;
 }
 
-// SYNC_SOLUTION에 따라 각 솔루션에 필요한 변수 초기값 설정
-static void InitializeSyncSolution(void)
-{
-#if SYNC_SOLUTION == 1
-    InitializeSemaphore(&SemaphoreMutex, 1);
-    InitializeSemaphore(&SemaphoreWriter, 1);
-    ReaderCount = 0;
-    PerformDelay = 3;
-
-#elif SYNC_SOLUTION == 2
-    InitializeSemaphore(&SemaphoreWriterMutex, 1);
-    InitializeSemaphore(&SemaphoreReaderMutex, 1);
-    InitializeSemaphore(&SemaphoreWriter, 1);
-    InitializeSemaphore(&SemaphoreReader, 1);
-    WriterCount = 0;
-    ReaderCount = 0;
-    PerformDelay = 1;
-
-#elif SYNC_SOLUTION == 3
-    InitializeSemaphore(&SemaphoreMutex, 1);
-    InitializeSemaphore(&SemaphoreWriter, 0);
-    InitializeSemaphore(&SemaphoreReader, 0);
-    WriterCount = 0;
-    ReaderCount = 0;
-    WriterWaitingCount = 0;
-    ReaderWaitingCount = 0;
-    PerformDelay = 1;
-#endif
+// Kboard 서비스 삭제, 링 버퍼가 참조하던 중복 제거 저장소의 값은 저장소를 지울 때 함께 해제
+static void DestroyKboard(void)
+{
+    kvfree(CurrentRing());
+    RCU_INIT_POINTER(RingBuffer, NULL);
+    vfree(Shared);
+    Shared = NULL;
+    free_percpu(WaitCpuStats);
+    WaitCpuStats = NULL;
 }
 
-// Writer가 CriticalSection에 진입하기위해 Lock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
-static void EnterCriticalSection_Writer(void)
+// 미러를 바꾸기 시작함, Sequence가 홀수인 동안 mmap한 Reader는 읽은 값을 버리고 다시 읽음
+static inline void SharedBegin(void)
 {
-#if SYNC_SOLUTION == 1
-    down(&SemaphoreWriter);
+    WRITE_ONCE(Shared->Sequence, Shared->Sequence + 1);
+    smp_wmb();
+}
 
-#elif SYNC_SOLUTION == 2
-    down(&SemaphoreWriterMutex);
-    WriterCount++;
-    if (WriterCount == 1)
-    {
-        down(&SemaphoreReader);
-    }
-    up(&SemaphoreWriterMutex);
-    down(&SemaphoreWriter);
+// 미러의 Count, CurrentIndex, Capacity를 링 버퍼와 맞추고 바꾸기를 끝냄
+static inline void SharedEnd(struct KboardRing *ring)
+{
+    WRITE_ONCE(Shared->Capacity, ring->Capacity);
+    WRITE_ONCE(Shared->Count, ring->Count);
+    WRITE_ONCE(Shared->CurrentIndex, ring->CurrentIndex);
+    smp_wmb();
+    WRITE_ONCE(Shared->Sequence, Shared->Sequence + 1);
+}
+
+// index 번 칸의 값, 비어 있으면 RING_BUFFER_INIT_VALUE
+// 중복 제거를 사용하면 저장소를 거쳐 읽음, 저장소의 값은 참조가 없어져도 RCU 유예 기간이 지난 뒤 해제
+static inline int RingValue(struct KboardRing *ring, int index)
+{
+    union KboardSlot *slot = &ring->Ring[index];
 
-#elif SYNC_SOLUTION == 3
-    down(&SemaphoreMutex);
-    if (WriterCount > 0 || ReaderCount > 0 ||
-        WriterWaitingCount > 0 || ReaderWaitingCount > 0)
+    if (KboardRing_slot(ring, index + ring->Capacity - ring->CurrentIndex) >= ring->Count)
     {
-        WriterWaitingCount++;
-        up(&SemaphoreMutex);
-        down(&SemaphoreWriter);
-        down(&SemaphoreMutex);
-        WriterWaitingCount--;
+        return RING_BUFFER_INIT_VALUE;
     }
-    WriterCount++;
-    up(&SemaphoreMutex);
-#endif
+
+    return dedup ? slot->Payload->Value : slot->Item;
 }
 
-// Reader가 CriticalSection에 진입하기위해 Lock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
-static void EnterCriticalSection_Reader(void)
+// 값을 담은 칸을 만듦, 중복 제거를 사용하면 저장소의 참조를 얻고 할당에 실패하면 -ENOMEM
+static inline int SlotMake(union KboardSlot *slot, int item, gfp_t gfp)
 {
-#if SYNC_SOLUTION == 1
-    down(&SemaphoreMutex);
-    ReaderCount++;
-    if (ReaderCount == 1)
+    if (!dedup)
     {
-        down(&SemaphoreWriter);
+        slot->Item = item;
+        return 0;
     }
-    up(&SemaphoreMutex);
 
-#elif SYNC_SOLUTION == 2
-    down(&SemaphoreReader);
-    up(&SemaphoreReader);
-    down(&SemaphoreReaderMutex);
-    ReaderCount++;
-    if (ReaderCount == 1)
-    {
-        down(&SemaphoreWriter);
-    }
-    up(&SemaphoreReaderMutex);
+    slot->Payload = PayloadGet(item, gfp);
 
-#elif SYNC_SOLUTION == 3
-    down(&SemaphoreMutex);
-    if (WriterWaitingCount > 0 || WriterCount > 0)
+    return slot->Payload != NULL ? 0 : -ENOMEM;
+}
+
+// 링 버퍼 끝에 값을 넣고 미러에 반영, 가득 찼는지는 호출하는 쪽에서 검사
+// 중복 제거 저장소의 참조를 얻지 못하면 넣지 않고 -ENOMEM
+static int RingPush(struct KboardRing *ring, int item, gfp_t gfp)
+{
+    int slot = KboardRing_slot(ring, ring->CurrentIndex + ring->Count);
+    union KboardSlot value;
+
+    if (SlotMake(&value, item, gfp) != 0)
     {
-        ReaderWaitingCount++;
-        up(&SemaphoreMutex);
-        down(&SemaphoreReader);
-        down(&SemaphoreMutex);
-        ReaderWaitingCount--;
+        return -ENOMEM;
     }
-    ReaderCount++;
-    up(&SemaphoreMutex);
-#endif
+
+    SharedBegin();
+    KboardRing_push(ring, value);
+    WRITE_ONCE(Shared->Items[slot], item);
+    SharedEnd(ring);
+
+    return 0;
 }
 
-// Writer가 CriticalSection으로부터 나가면서 Unlock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
-static void LeaveCriticalSection_Writer(void)
+// 링 버퍼 앞의 값을 꺼내 반환하고 미러에 반영, 중복 제거 저장소의 참조도 해제, 비었는지는 호출하는 쪽에서 검사
+static int RingPop(struct KboardRing *ring)
 {
-#if SYNC_SOLUTION == 1
-    up(&SemaphoreWriter);
+    int slot = ring->CurrentIndex;
+    int item = RingValue(ring, slot);
 
-#elif SYNC_SOLUTION == 2
-    up(&SemaphoreWriter);
-    down(&SemaphoreWriterMutex);
-    WriterCount--;
-    if (WriterCount == 0)
+    if (dedup)
     {
-        up(&SemaphoreReader);
+        PayloadPut(KboardRing_front(ring)->Payload);
     }
-    up(&SemaphoreWriterMutex);
 
-#elif SYNC_SOLUTION == 3
-    int index;
+    SharedBegin();
+    KboardRing_pop(ring);
+    WRITE_ONCE(Shared->Items[slot], RING_BUFFER_INIT_VALUE);
+    SharedEnd(ring);
+
+    return item;
+}
 
-    down(&SemaphoreMutex);
-    WriterCount--;
-    if (ReaderWaitingCount > 0)
+// 링 버퍼의 빈 칸을 백로그의 가장 오래된 값부터 채움, BacklogLock을 잡은 상태에서 호출하므로 GFP_ATOMIC
+// 중복 제거 저장소의 할당에 실패하면 남은 값은 백로그에 두고 다음 Dequeue에서 다시 채움
+static void RingRefill(struct KboardRing *ring)
+{
+    while (BacklogCount > 0 && !KboardRing_is_full(ring))
     {
-        for (index = 0; index < ReaderWaitingCount; index++)
+        if (RingPush(ring, BacklogPeek(), GFP_ATOMIC) != 0)
         {
-            up(&SemaphoreReader);
+            break;
         }
+        BacklogTake(true);
     }
-    else if (WriterWaitingCount > 0)
+}
+
+// 미러 전체를 링 버퍼와 맞춤, 용량을 줄였으면 이전 용량(clear)까지 남은 칸을 비움
+static void SharedSync(struct KboardRing *ring, int clear)
+{
+    int index;
+
+    SharedBegin();
+    for (index = 0; index < max(ring->Capacity, clear); index++)
     {
-        up(&SemaphoreWriter);
+        WRITE_ONCE(Shared->Items[index], index < ring->Capacity ? RingValue(ring, index) : RING_BUFFER_INIT_VALUE);
     }
-    up(&SemaphoreMutex);
-#endif
+    SharedEnd(ring);
 }
 
-// Reader가 CriticalSection으로부터 나가면서 Unlock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
-static void LeaveCriticalSection_Reader(void)
+// (pid, role)을 키로 하는 개방 주소법 해시 테이블에서 Task 항목을 찾고 없으면 새로 만듦, 가득 찼으면 NULL
+static struct WaitTaskStat *WaitTaskFind(struct WaitCpuStat *cpuStat, pid_t pid, int role)
 {
-#if SYNC_SOLUTION == 1
-    down(&SemaphoreMutex);
-    ReaderCount--;
-    if (ReaderCount == 0)
+    struct WaitTaskStat *task;
+    u32 slot;
+    int probe;
+
+    slot = hash_32((u32)pid * WAIT_ROLE_COUNT + role, WAIT_TASK_BITS);
+    for (probe = 0; probe < WAIT_TASK_MAX; probe++)
     {
-        up(&SemaphoreWriter);
+        task = &cpuStat->Tasks[(slot + probe) % WAIT_TASK_MAX];
+        if (task->Count == 0)
+        {
+            task->Pid = pid;
+            task->Role = role;
+            cpuStat->TaskCount++;
+            return task;
+        }
+        if (task->Pid == pid && task->Role == role)
+        {
+            return task;
+        }
     }
-    up(&SemaphoreMutex);
 
-#elif SYNC_SOLUTION == 2
-    down(&SemaphoreReaderMutex);
-    ReaderCount--;
-    if (ReaderCount == 0)
+    return NULL;
+}
+
+// 현재 CPU의 역할별 분포와 현재 Task의 대기 시간 합계에 한 번의 대기를 기록
+static void RecordWait(int role, u64 waitNs)
+{
+    struct WaitCpuStat *cpuStat;
+    struct WaitStat *stat;
+    struct WaitTaskStat *task;
+    pid_t pid = current->pid;
+
+    cpuStat = get_cpu_ptr(WaitCpuStats);
+    spin_lock(&cpuStat->Lock);
+
+    stat = &cpuStat->Roles[role];
+    stat->Count++;
+    stat->TotalNs += waitNs;
+    stat->MaxNs = max(stat->MaxNs, waitNs);
+    stat->Histogram[waitNs == 0 ? 0 : fls64(waitNs) - 1]++;
+
+    task = WaitTaskFind(cpuStat, pid, role);
+    if (task == NULL)
     {
-        up(&SemaphoreWriter);
+        cpuStat->TaskOverflow++;
     }
-    up(&SemaphoreReaderMutex);
-
-#elif SYNC_SOLUTION == 3
-    down(&SemaphoreMutex);
-    ReaderCount--;
-    if (ReaderCount == 0 && WriterWaitingCount > 0)
+    else
     {
-        up(&SemaphoreWriter);
+        task->Count++;
+        task->TotalNs += waitNs;
+        task->MaxNs = max(task->MaxNs, waitNs);
     }
-    up(&SemaphoreMutex);
-#endif
+
+    spin_unlock(&cpuStat->Lock);
+    put_cpu_ptr(WaitCpuStats);
 }
 
-// Writer의 Write, Read 인터페이스 관련 메서드들
-static int KboardWriter_Open(struct inode * inode, struct file * file)
+// Writer로 Critical Section에 진입하고 대기 시간을 기록
+static void EnterWriter(void)
 {
-    printk(KERN_DEBUG "'%s'\n", __func__);
-    return single_open(file, KboardWriter_Show, NULL);
+    u64 start = ktime_get_ns();
+
+    EnterCriticalSection_Writer();
+    RecordWait(WAIT_ROLE_WRITER, ktime_get_ns() - start);
 }
 
-// Writer: Read(), Kboard에서 Dequeue를 수행
-static int KboardWriter_Show(struct seq_file * file, void * unused)
+// Reader로 Critical Section에 진입하고 대기 시간을 기록
+static void EnterReader(void)
 {
-    int item;
+    u64 start = ktime_get_ns();
 
-    printk(KERN_DEBUG "'%s'\n", __func__);
+    EnterCriticalSection_Reader();
+    RecordWait(WAIT_ROLE_READER, ktime_get_ns() - start);
+}
 
-    EnterCriticalSection_Writer();
-	mdelay(PerformDelay);
-    PerformWriter++;
+// 모든 CPU의 대기 시간 측정값 초기화
+static void ResetWaitStat(void)
+{
+    struct WaitCpuStat *cpuStat;
+    int cpu;
 
-    // 링 버퍼가 비어 있는지 검사
-    if (RingBufferCount <= 0)
+    for_each_possible_cpu(cpu)
     {
-        printk("%s: Ring buffer is empty, count: '%d'\n", __func__, RingBufferCount);
-        LeaveCriticalSection_Writer();
-        return -EPERM;
+        cpuStat = per_cpu_ptr(WaitCpuStats, cpu);
+        spin_lock(&cpuStat->Lock);
+        memset(cpuStat->Roles, 0, sizeof(cpuStat->Roles));
+        memset(cpuStat->Tasks, 0, sizeof(cpuStat->Tasks));
+        cpuStat->TaskCount = 0;
+        cpuStat->TaskOverflow = 0;
+        spin_unlock(&cpuStat->Lock);
     }
+}
 
-    item = RingBuffer[RingBufferCurrentIndex];
-    RingBuffer[RingBufferCurrentIndex] = RING_BUFFER_INIT_VALUE;
-    RingBufferCount--;
-    RingBufferCurrentIndex = (RingBufferCurrentIndex + 1) % RING_BUFFER_SIZE;
+// 모든 CPU의 측정값을 total에 합침, Task 항목은 (pid, role)별로 합하고 합친 테이블이 가득 차면 넘친 것으로 셈
+static void FoldWaitStat(struct WaitCpuStat *total)
+{
+    struct WaitCpuStat *cpuStat;
+    struct WaitStat *stat;
+    struct WaitTaskStat *task;
+    struct WaitTaskStat *merged;
+    int cpu;
+    int role;
+    int index;
 
-    LeaveCriticalSection_Writer();
+    for_each_possible_cpu(cpu)
+    {
+        cpuStat = per_cpu_ptr(WaitCpuStats, cpu);
+        spin_lock(&cpuStat->Lock);
 
-    seq_printf(file, "Paste: '%d'\n", item);
+        for (role = 0; role < WAIT_ROLE_COUNT; role++)
+        {
+            stat = &total->Roles[role];
+            stat->Count += cpuStat->Roles[role].Count;
+            stat->TotalNs += cpuStat->Roles[role].TotalNs;
+            stat->MaxNs = max(stat->MaxNs, cpuStat->Roles[role].MaxNs);
+            for (index = 0; index < WAIT_HISTOGRAM_SIZE; index++)
+            {
+                stat->Histogram[index] += cpuStat->Roles[role].Histogram[index];
+            }
+        }
 
-    return 0;
+        for (index = 0; index < WAIT_TASK_MAX; index++)
+        {
+            task = &cpuStat->Tasks[index];
+            if (task->Count == 0)
+            {
+                continue;
+            }
+
+            merged = WaitTaskFind(total, task->Pid, task->Role);
+            if (merged == NULL)
+            {
+                total->TaskOverflow += task->Count;
+                continue;
+            }
+            merged->Count += task->Count;
+            merged->TotalNs += task->TotalNs;
+            merged->MaxNs = max(merged->MaxNs, task->MaxNs);
+        }
+        total->TaskOverflow += cpuStat->TaskOverflow;
+
+        spin_unlock(&cpuStat->Lock);
+    }
 }
 
-// Writer: Write(), Kboard에 Enqueue를 수행
-static ssize_t KboardWriter_Write(struct file * file, const char __user * data, size_t length, loff_t * off)
+// Kboard에 Enqueue를 수행, 음수 값이면 -EINVAL, 링 버퍼가 가득 찼으면 -ENOSPC, 필터가 버리면 넣지 않고 0
+static int KboardEnqueue(int item)
 {
-    int item;
-    char buffer[WRITER_BUFFER_SIZE];
-
-    printk(KERN_DEBUG "'%s'\n", __func__);
-
-    // 입력값 검사
-    if (length > WRITER_BUFFER_SIZE)
-    {
-        printk(KERN_DEBUG "%s: Data length is too long, length: '%ld', max: '%d'\n",
-            __func__, length, WRITER_BUFFER_SIZE);
-        return -E2BIG;
-    }
+    int filtered;
 
-    if (copy_from_user(buffer, data, length) != 0)
+    filtered = kb_filter_apply(&Filter, &item);
+    if (filtered != 0)
     {
-        printk(KERN_DEBUG "%s: Failed copy_from_user, UserAddress: '0x%p', Length: '%ld'\n",
-            __func__, data, length);
-        return -EFAULT;
+        return filtered == KB_FILTER_DROPPED ? 0 : filtered;
     }
 
-    if (sscanf(buffer, "%d", &item) != 1)
-    {
-        printk(KERN_DEBUG "%s: Invaild argument, must input 1 integer", __func__);
-        return -EINVAL;
-    }
+    return KboardEnqueueBatch(&item, 1) == 1 ? 0 : -ENOSPC;
+}
 
-    // 입력값이 음수인지 검사
-    if (item < 0)
-    {
-        printk(KERN_DEBUG "%s: Item cannot be negative value, item : '%d'\n", __func__, item);
-        return -EINVAL;
-    }
+// 한 번의 Critical Section 안에서 링 버퍼와 백로그가 가득 찰 때까지 값들을 Enqueue, 넣은 개수를 반환
+// 필터와 음수 값 검사는 호출하는 쪽에서 수행
+static int KboardEnqueueBatch(const int *items, int count)
+{
+    struct KboardRing *ring;
+    int accepted;
 
-    EnterCriticalSection_Writer();
+    EnterWriter();
 	mdelay(PerformDelay);
     PerformWriter++;
 
-    // 링 버퍼가 가득찼는지 검사
-    if (RingBufferCount >= RING_BUFFER_SIZE)
+    ring = CurrentRing();
+    for (accepted = 0; accepted < count; accepted++)
     {
-        printk(KERN_DEBUG "%s: Ring buffer is full, count: '%d'\n", __func__, RingBufferCount);
-        LeaveCriticalSection_Writer();
-        return -EPERM;
-    }
-
-    RingBuffer[(RingBufferCurrentIndex + RingBufferCount) % RING_BUFFER_SIZE] = item;
-    RingBufferCount++;
+        // 링 버퍼가 가득 찼거나 백로그에 옮기지 못한 값이 남았으면 백로그 뒤에 넣음
+        if (KboardRing_is_full(ring) || READ_ONCE(BacklogCount) > 0)
+        {
+            if (BacklogPush(items[accepted]) != 0)
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (RingPush(ring, items[accepted], GFP_KERNEL) != 0)
+        {
+            break;
+        }
+    }
+
+    NotifyClips(items, accepted);
+
+    LeaveCriticalSection_Writer();
+
+    return accepted;
+}
+
+// Kboard에서 Dequeue를 수행, 링 버퍼가 비어 있으면 -ENODATA
+static int KboardDequeue(int *item)
+{
+    return KboardDequeueBatch(item, 1) == 1 ? 0 : -ENODATA;
+}
+
+// 한 번의 Critical Section 안에서 최대 count 개를 Dequeue, 꺼낸 개수를 반환
+static int KboardDequeueBatch(int *items, int count)
+{
+    struct KboardRing *ring;
+    int taken;
+
+    EnterWriter();
+	mdelay(PerformDelay);
+    PerformWriter++;
+
+    ring = CurrentRing();
+    spin_lock(&BacklogLock);
+
+    for (taken = 0; taken < count && !KboardRing_is_empty(ring); taken++)
+    {
+        items[taken] = RingPop(ring);
+
+        // 빈 칸에 백로그의 가장 오래된 값을 옮김
+        RingRefill(ring);
+    }
+
+    spin_unlock(&BacklogLock);
+
+    LeaveCriticalSection_Writer();
+
+    return taken;
+}
+
+// 한 번의 Critical Section 안에서 from의 __s32 값들을 최대 count 개까지 링 버퍼와 백로그에 바로 복사하며 Enqueue, 처리한 개수를 반환
+// 중간 버퍼를 거치지 않으므로 splice로 넘어온 파이프 페이지에서도 한 번만 복사, 필터가 버린 값도 처리한 개수에 포함
+// count 개를 넣기 전에 멈추면 *error에 이유를 설정, 음수 값이면 -EINVAL, 복사 실패는 -EFAULT, 가득 찼으면 -ENOSPC
+static int KboardEnqueueIter(struct iov_iter *from, int count, int *error)
+{
+    struct KboardRing *ring;
+    int accepted;
+    int item;
+    int filtered;
+
+    EnterWriter();
+	mdelay(PerformDelay);
+    PerformWriter++;
+
+    ring = CurrentRing();
+    for (accepted = 0; accepted < count; accepted++)
+    {
+        if (copy_from_iter(&item, sizeof(item), from) != sizeof(item))
+        {
+            *error = -EFAULT;
+            break;
+        }
+
+        filtered = kb_filter_apply(&Filter, &item);
+        if (filtered < 0)
+        {
+            *error = filtered;
+            break;
+        }
+
+        if (filtered == KB_FILTER_DROPPED)
+        {
+            continue;
+        }
+
+        // 링 버퍼가 가득 찼거나 백로그에 옮기지 못한 값이 남았으면 백로그 뒤에 넣음
+        if (KboardRing_is_full(ring) || READ_ONCE(BacklogCount) > 0)
+        {
+            if (BacklogPush(item) != 0)
+            {
+                *error = -ENOSPC;
+                break;
+            }
+        }
+        else if (RingPush(ring, item, GFP_KERNEL) != 0)
+        {
+            *error = -ENOMEM;
+            break;
+        }
+
+        NotifyClips(&item, 1);
+    }
+
+    LeaveCriticalSection_Writer();
+
+    return accepted;
+}
+
+// 한 번의 Critical Section 안에서 최대 count 개를 링 버퍼에서 to로 바로 복사하며 Dequeue, 꺼낸 개수를 반환
+// 복사에 성공한 값만 꺼내므로 주소가 잘못되었거나 파이프가 가득 차도 값을 잃지 않음, 복사에 실패하면 *error에 -EFAULT
+static int KboardDequeueIter(struct iov_iter *to, int count, int *error)
+{
+    struct KboardRing *ring;
+    int taken;
+    int item;
+
+    EnterWriter();
+	mdelay(PerformDelay);
+    PerformWriter++;
+
+    ring = CurrentRing();
+    for (taken = 0; taken < count && !KboardRing_is_empty(ring); taken++)
+    {
+        item = RingValue(ring, ring->CurrentIndex);
+        if (copy_to_iter(&item, sizeof(item), to) != sizeof(item))
+        {
+            *error = -EFAULT;
+            break;
+        }
+        RingPop(ring);
+
+        // 복사하는 동안 페이지 폴트로 잠들 수 있으므로 BacklogLock은 값마다 잡고 빈 칸에 백로그의 가장 오래된 값을 옮김
+        spin_lock(&BacklogLock);
+        RingRefill(ring);
+        spin_unlock(&BacklogLock);
+    }
+
+    LeaveCriticalSection_Writer();
+
+    return taken;
+}
+
+// Kboard의 링 버퍼에서 값이 들어있는 칸 하나를 무작위로 읽음, 비어 있으면 -ENODATA
+static int KboardSample(unsigned int *index, int *item)
+{
+    return KboardSampleBatch(item, index, 1) == 1 ? 0 : -ENODATA;
+}
+
+// 한 번의 Critical Section 안에서 값이 들어있는 칸들 중 count 개를 복원 추출, 읽은 개수를 반환
+// 칸의 위치가 필요 없으면 indexes는 NULL
+static int KboardSampleBatch(int *items, unsigned int *indexes, int count)
+{
+    struct KboardRing *ring;
+    struct rnd_state *state;
+    unsigned int slot;
+    int sampled;
+
+    EnterReader();
+	mdelay(PerformDelay);
+    PerformReader++;
+
+    // 용량 변경은 Reader와 함께 Critical Section에 들어와 링 버퍼를 교체하므로 RCU 안에서 읽음
+    // 교체 전의 링 버퍼를 읽고 있어도 유예 기간이 끝날 때까지 해제되지 않고 값도 바뀌지 않음
+    rcu_read_lock();
+    ring = rcu_dereference(RingBuffer);
+    if (ring->Count <= 0)
+    {
+        rcu_read_unlock();
+        LeaveCriticalSection_Reader();
+        return 0;
+    }
+
+    // CPU별 상태를 사용하므로 다른 CPU의 Reader와 캐시 라인을 공유하지 않음
+    state = get_cpu_ptr(&SampleRandomState);
+    for (sampled = 0; sampled < count; sampled++)
+    {
+        slot = KboardRing_slot(ring, ring->CurrentIndex + reciprocal_scale(prandom_u32_state(state), ring->Count));
+        items[sampled] = RingValue(ring, slot);
+        if (indexes != NULL)
+        {
+            indexes[sampled] = slot;
+        }
+    }
+    put_cpu_ptr(&SampleRandomState);
+    rcu_read_unlock();
+
+    LeaveCriticalSection_Reader();
+
+    return sampled;
+}
+
+// 백로그 끝에 값을 넣음, Writer Critical Section 안에서 호출
+// 백로그가 최대 개수에 도달했으면 -ENOSPC, 덩어리 할당에 실패하면 (memcg 한도 포함) -ENOMEM
+static int BacklogPush(int item)
+{
+    struct KboardBacklogChunk *chunk;
+    struct KboardBacklogChunk *fresh = NULL;
+
+    spin_lock(&BacklogLock);
+
+    while (true)
+    {
+        if (BacklogCount >= READ_ONCE(backlog_max))
+        {
+            spin_unlock(&BacklogLock);
+            kfree(fresh);
+            return -ENOSPC;
+        }
+
+        chunk = list_empty(&Backlog) ? NULL : list_last_entry(&Backlog, struct KboardBacklogChunk, List);
+        if (chunk != NULL && chunk->Tail < BACKLOG_CHUNK_ITEMS)
+        {
+            break;
+        }
+
+        // 앞에서 할당한 덩어리를 연결
+        if (fresh != NULL)
+        {
+            list_add_tail(&fresh->List, &Backlog);
+            BacklogChunks++;
+            chunk = fresh;
+            fresh = NULL;
+            break;
+        }
+
+        // 마지막 덩어리가 가득 찼으면 잠금을 풀고 새 덩어리를 할당한 뒤 다시 검사, 그 사이 Shrinker가 목록을 바꿀 수 있음
+        spin_unlock(&BacklogLock);
+        fresh = kmalloc(sizeof(*fresh), GFP_KERNEL_ACCOUNT);
+        if (fresh == NULL)
+        {
+            return -ENOMEM;
+        }
+        fresh->Head = 0;
+        fresh->Tail = 0;
+        spin_lock(&BacklogLock);
+    }
+
+    chunk->Items[chunk->Tail++] = item;
+    BacklogCount++;
+
+    spin_unlock(&BacklogLock);
+    kfree(fresh);
+
+    return 0;
+}
+
+// 백로그에서 가장 오래된 값을 꺼내지 않고 읽음
+// BacklogLock을 잡은 상태에서 BacklogCount > 0일 때 호출
+static int BacklogPeek(void)
+{
+    struct KboardBacklogChunk *chunk = list_first_entry(&Backlog, struct KboardBacklogChunk, List);
+
+    return chunk->Items[chunk->Head];
+}
+
+// 백로그에서 가장 오래된 값 또는 가장 최근 값을 꺼냄, 빈 덩어리는 해제
+// BacklogLock을 잡은 상태에서 BacklogCount > 0일 때 호출
+static int BacklogTake(bool oldest)
+{
+    struct KboardBacklogChunk *chunk;
+    int item;
+
+    if (oldest)
+    {
+        chunk = list_first_entry(&Backlog, struct KboardBacklogChunk, List);
+        item = chunk->Items[chunk->Head++];
+    }
+    else
+    {
+        chunk = list_last_entry(&Backlog, struct KboardBacklogChunk, List);
+        item = chunk->Items[--chunk->Tail];
+    }
+    BacklogCount--;
+
+    if (chunk->Head == chunk->Tail)
+    {
+        list_del(&chunk->List);
+        BacklogChunks--;
+        kfree(chunk);
+    }
+
+    return item;
+}
+
+// 백로그의 모든 덩어리를 해제
+static void DestroyBacklog(void)
+{
+    struct KboardBacklogChunk *chunk;
+    struct KboardBacklogChunk *next;
+
+    spin_lock(&BacklogLock);
+    list_for_each_entry_safe(chunk, next, &Backlog, List)
+    {
+        list_del(&chunk->List);
+        kfree(chunk);
+    }
+    BacklogCount = 0;
+    BacklogChunks = 0;
+    spin_unlock(&BacklogLock);
+}
+
+// 중복 제거 저장소에서 값을 찾아 참조를 늘리고, 없으면 gfp로 할당해 새로 넣음, 할당에 실패하면 NULL
+static struct KboardPayload *PayloadGet(int value, gfp_t gfp)
+{
+    struct KboardPayload *payload;
+    struct KboardPayload *fresh = NULL;
+    struct KboardPayload *old;
+
+    DedupLookups++;
+
+    while (true)
+    {
+        // 잠금 없이 조회, 지워지는 중인 값(참조 0)은 건너뜀
+        rcu_read_lock();
+        payload = rhashtable_lookup(&PayloadTable, &value, PAYLOAD_TABLE_PARAMS);
+        if (payload != NULL && refcount_inc_not_zero(&payload->Reference))
+        {
+            rcu_read_unlock();
+            DedupHits++;
+            DedupReferences++;
+            kfree(fresh);
+            return payload;
+        }
+        rcu_read_unlock();
+
+        if (fresh == NULL)
+        {
+            fresh = kmalloc(sizeof(*fresh), gfp);
+            if (fresh == NULL)
+            {
+                return NULL;
+            }
+            fresh->Value = value;
+            refcount_set(&fresh->Reference, 1);
+        }
+
+        // 같은 값이 먼저 들어갔거나 지워지는 중이면 다시 조회
+        rcu_read_lock();
+        old = rhashtable_lookup_get_insert_fast(&PayloadTable, &fresh->Node, PAYLOAD_TABLE_PARAMS);
+        rcu_read_unlock();
+        if (old == NULL)
+        {
+            DedupReferences++;
+            DedupStoreBytes += ksize(fresh);
+            return fresh;
+        }
+        if (IS_ERR(old))
+        {
+            kfree(fresh);
+            return NULL;
+        }
+    }
+}
+
+// 값의 참조를 줄이고 마지막 참조였으면 저장소에서 지움
+static void PayloadPut(struct KboardPayload *payload)
+{
+    if (payload == NULL)
+    {
+        return;
+    }
+
+    DedupReferences--;
+    if (refcount_dec_and_test(&payload->Reference))
+    {
+        rhashtable_remove_fast(&PayloadTable, &payload->Node, PAYLOAD_TABLE_PARAMS);
+        DedupStoreBytes -= ksize(payload);
+        kfree_rcu(payload, Rcu);
+    }
+}
+
+// 모듈을 내릴 때 남은 값을 해제
+static void KboardPayload_Free(void *object, void *argument)
+{
+    kfree(object);
+}
+
+// 새로 들어온 값들을 알림 버퍼에 쌓음, Writer Critical Section 안에서 호출
+// 구독자가 없으면 아무것도 하지 않고, 첫 값이 들어오면 notify_window_us 뒤에 보내도록 예약, 버퍼가 차면 바로 보냄
+static void NotifyClips(const int *items, int count)
+{
+    int copied;
+
+    if (count <= 0 || !genl_has_listeners(&KboardFamily, &init_net, 0))
+    {
+        return;
+    }
+
+    spin_lock(&NotifyLock);
+
+    copied = min(count, NOTIFY_BATCH_MAX - NotifyCount);
+    memcpy(&NotifyItems[NotifyCount], items, sizeof(int) * copied);
+    NotifyDropped += count - copied;
+
+    if (NotifyCount == 0)
+    {
+        schedule_delayed_work(&NotifyWork, usecs_to_jiffies(max(READ_ONCE(notify_window_us), 0)));
+    }
+    NotifyCount += copied;
+
+    if (NotifyCount >= NOTIFY_BATCH_MAX)
+    {
+        mod_delayed_work(system_wq, &NotifyWork, 0);
+    }
+
+    spin_unlock(&NotifyLock);
+}
+
+// 쌓인 값들을 하나의 KBOARD_CMD_CLIPS 메시지로 "clips" 그룹에 멀티캐스트
+// 작업은 동시에 두 번 실행되지 않으므로 보낼 값은 정적 버퍼에 옮겨 잠금 밖에서 메시지를 만듦
+static void KboardNotify_Work(struct work_struct * work)
+{
+    static int items[NOTIFY_BATCH_MAX];
+    struct sk_buff *message;
+    void *header;
+    int count;
+    u32 dropped;
+
+    spin_lock(&NotifyLock);
+    count = NotifyCount;
+    dropped = NotifyDropped;
+    memcpy(items, NotifyItems, sizeof(int) * count);
+    NotifyCount = 0;
+    NotifyDropped = 0;
+    spin_unlock(&NotifyLock);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    message = genlmsg_new(nla_total_size(sizeof(int) * count) + nla_total_size(sizeof(u32)), GFP_KERNEL);
+    if (message == NULL)
+    {
+        return;
+    }
+
+    header = genlmsg_put(message, 0, 0, &KboardFamily, 0, KBOARD_CMD_CLIPS);
+    if (header == NULL
+        || nla_put(message, KBOARD_ATTR_ITEMS, sizeof(int) * count, items) != 0
+        || (dropped != 0 && nla_put_u32(message, KBOARD_ATTR_DROPPED, dropped) != 0))
+    {
+        nlmsg_free(message);
+        return;
+    }
+    genlmsg_end(message, header);
+
+    // 그 사이 구독자가 모두 떠났으면 -ESRCH, 알릴 대상이 없으므로 무시
+    genlmsg_multicast(&KboardFamily, message, 0, 0, GFP_KERNEL);
+}
+
+// Shrinker: 정책에 따라 버릴 수 있는 값의 개수
+static unsigned long KboardShrinker_Count(struct shrinker * shrinker, struct shrink_control * control)
+{
+    if (READ_ONCE(shrink_policy) == SHRINK_POLICY_NONE)
+    {
+        return 0;
+    }
+
+    return READ_ONCE(BacklogCount);
+}
+
+// Shrinker: 백로그에서 최대 nr_to_scan 개의 값을 정책에 따라 버리고 버린 개수를 반환
+static unsigned long KboardShrinker_Scan(struct shrinker * shrinker, struct shrink_control * control)
+{
+    int policy = READ_ONCE(shrink_policy);
+    unsigned long dropped = 0;
+
+    if (policy != SHRINK_POLICY_OLDEST && policy != SHRINK_POLICY_NEWEST)
+    {
+        return SHRINK_STOP;
+    }
+
+    spin_lock(&BacklogLock);
+    while (dropped < control->nr_to_scan && BacklogCount > 0)
+    {
+        BacklogTake(policy == SHRINK_POLICY_OLDEST);
+        dropped++;
+    }
+    BacklogDropped += dropped;
+    spin_unlock(&BacklogLock);
+
+    if (dropped == 0)
+    {
+        return SHRINK_STOP;
+    }
+
+    printk(KERN_INFO "kboard: dropped %lu %s clips under memory pressure\n",
+        dropped, policy == SHRINK_POLICY_OLDEST ? "oldest" : "newest");
+
+    return dropped;
+}
+
+// 링 버퍼의 복사본을 만듦, 메모리 할당은 잠금 밖에서 하고 복사하는 동안만 Writer를 막음
+// 할당한 크기와 용량이 어긋나지 않도록 ResizeLock을 잡아 그동안 용량 변경을 미룸
+// 미러는 Writer만 바꾸고 칸마다 RingValue()와 같은 값을 담으므로, 칸마다 읽는 대신 미러를 한 번에 복사
+// Dumper, Snapshot은 Reader 통계에 포함하지 않도록 EnterReader() 대신 직접 진입
+static struct KboardSnapshot *TakeSnapshot(size_t *size)
+{
+    struct KboardSnapshot *snapshot;
+    struct KboardRing *ring;
+
+    mutex_lock(&ResizeLock);
+    ring = CurrentRing();
+
+    *size = sizeof(*snapshot) + sizeof(int) * ring->Capacity;
+    snapshot = kvmalloc(*size, GFP_KERNEL);
+    if (snapshot == NULL)
+    {
+        mutex_unlock(&ResizeLock);
+        return NULL;
+    }
+
+    snapshot->Header.Magic = KBOARD_SNAPSHOT_MAGIC;
+    snapshot->Header.Version = KBOARD_SNAPSHOT_VERSION;
+    snapshot->Header.Capacity = ring->Capacity;
+    snapshot->Header.SyncSolution = SYNC_SOLUTION;
+
+    EnterCriticalSection_Reader();
+    memcpy(snapshot->Items, Shared->Items, sizeof(int) * ring->Capacity);
+    snapshot->Header.Count = ring->Count;
+    snapshot->Header.CurrentIndex = ring->CurrentIndex;
+    snapshot->Header.PerformWriter = PerformWriter;
+    snapshot->Header.PerformReader = PerformReader;
+    LeaveCriticalSection_Reader();
+
+    mutex_unlock(&ResizeLock);
+
+    return snapshot;
+}
+
+// 링 버퍼의 용량을 바꿈, 새 링 버퍼를 할당해 값을 순서대로 옮긴 뒤 한 번에 교체
+// 옮기는 동안 Reader로 Critical Section에 들어가 Writer만 막으므로 Reader는 기다리지 않고 이전 링 버퍼를 계속 읽음
+// 범위를 벗어나면 -EINVAL, 저장된 값의 개수보다 작게 줄이면 -EBUSY, 할당에 실패하면 -ENOMEM
+static int KboardResize(int newCapacity)
+{
+    struct KboardRing *old;
+    struct KboardRing *ring;
+    union KboardSlot slot;
+    int oldCapacity;
+
+    if (newCapacity <= 0 || newCapacity > RING_CAPACITY_MAX)
+    {
+        return -EINVAL;
+    }
+
+    mutex_lock(&ResizeLock);
+
+    old = CurrentRing();
+    oldCapacity = old->Capacity;
+    if (newCapacity == oldCapacity)
+    {
+        mutex_unlock(&ResizeLock);
+        return 0;
+    }
+
+    ring = kvmalloc(KboardRing_size(newCapacity), GFP_KERNEL);
+    if (ring == NULL)
+    {
+        mutex_unlock(&ResizeLock);
+        return -ENOMEM;
+    }
+    KboardRing_init(ring, newCapacity);
+
+    EnterCriticalSection_Reader();
+
+    if (old->Count > newCapacity)
+    {
+        LeaveCriticalSection_Reader();
+        mutex_unlock(&ResizeLock);
+        kvfree(ring);
+        return -EBUSY;
+    }
+
+    // 값 또는 중복 제거 저장소의 참조를 그대로 옮김, 이전 링 버퍼는 Reader가 읽고 있으므로 바꾸지 않고 참조도 해제하지 않음
+    KboardRing_copy(ring, old);
+
+    // 늘어난 칸을 백로그의 오래된 값부터 채움, Writer가 없으므로 중복 제거 통계도 여기서 갱신할 수 있음
+    // 새 링 버퍼는 아직 미러와 연결되지 않았으므로 RingPush 대신 직접 넣고 아래에서 미러 전체를 맞춤
+    spin_lock(&BacklogLock);
+    while (BacklogCount > 0 && !KboardRing_is_full(ring))
+    {
+        if (SlotMake(&slot, BacklogPeek(), GFP_ATOMIC) != 0)
+        {
+            break;
+        }
+        BacklogTake(true);
+        KboardRing_push(ring, slot);
+    }
+    spin_unlock(&BacklogLock);
+
+    rcu_assign_pointer(RingBuffer, ring);
+    WRITE_ONCE(capacity, newCapacity);
+
+    // 새 링 버퍼는 0 번 칸부터 다시 놓였으므로 미러 전체를 맞춤
+    SharedSync(ring, oldCapacity);
+
+    LeaveCriticalSection_Reader();
+
+    // 이전 링 버퍼를 읽던 Reader가 모두 빠져나간 뒤 해제
+    synchronize_rcu();
+    kvfree(old);
+
+    mutex_unlock(&ResizeLock);
+
+    printk(KERN_INFO "kboard: resized ring buffer from '%d' to '%d'\n", oldCapacity, newCapacity);
+
+    return 0;
+}
+
+// 링 버퍼에 들어있는 값의 개수, 잠금 없이 읽으므로 출력에만 사용
+static int KboardCount(void)
+{
+    int count;
+
+    rcu_read_lock();
+    count = READ_ONCE(rcu_dereference(RingBuffer)->Count);
+    rcu_read_unlock();
+
+    return count;
+}
+
+// Writer의 Write, Read 인터페이스 관련 메서드들
+static int KboardWriter_Open(struct inode * inode, struct file * file)
+{
+    struct KboardWriterResult *writerResult;
+    int result;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    writerResult = kzalloc(sizeof(*writerResult), GFP_KERNEL);
+    if (writerResult == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    result = single_open(file, KboardWriter_Show, writerResult);
+    if (result != 0)
+    {
+        kfree(writerResult);
+    }
+
+    return result;
+}
+
+static int KboardWriter_Release(struct inode * inode, struct file * file)
+{
+    kfree(((struct seq_file *)file->private_data)->private);
+
+    return single_release(inode, file);
+}
+
+// Writer: Read(), Kboard에서 Dequeue를 수행
+// 같은 파일로 Write()한 뒤 처음 읽으면 Dequeue 대신 그 Write()에서 넣은 값의 개수를 보여줌 (offset 0 에서 읽어야 함)
+static int KboardWriter_Show(struct seq_file * file, void * unused)
+{
+    struct KboardWriterResult *writerResult = file->private;
+    int item;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    if (writerResult->Pending)
+    {
+        writerResult->Pending = false;
+        seq_printf(file, "Accepted: '%d' of '%d'\n", writerResult->Accepted, writerResult->Count);
+        return 0;
+    }
+
+    // 링 버퍼가 비어 있는지 검사
+    if (KboardDequeue(&item) != 0)
+    {
+        printk("%s: Ring buffer is empty, count: '%d'\n", __func__, KboardCount());
+        return -EPERM;
+    }
+
+    seq_printf(file, "Paste: '%d'\n", item);
+
+    return 0;
+}
+
+// Writer: Write(), 공백으로 구분된 정수들을 한 번의 Critical Section 안에서 Kboard에 Enqueue
+// 모두 넣으면 length를, 링 버퍼가 가득 차 일부만 넣으면 마지막으로 넣은 값까지의 바이트 수를 반환, 필터가 버린 값은 넣은 것으로 봄
+// 넣은 값의 개수는 같은 파일을 offset 0 에서 읽어 "Accepted: 'N' of 'M'"으로 확인
+static ssize_t KboardWriter_Write(struct file * file, const char __user * data, size_t length, loff_t * off)
+{
+    struct seq_file *seq = file->private_data;
+    struct KboardWriterResult *writerResult = seq->private;
+    char *buffer;
+    char *cursor;
+    char *token;
+    int *items = NULL;
+    struct KboardWriterToken *itemTokens = NULL;
+    int tokens = 0;
+    int parsed = 0;
+    int count = 0;
+    int accepted;
+    int filtered;
+    ssize_t result;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    // 입력값 검사
+    if (length > WRITER_BUFFER_SIZE)
+    {
+        printk(KERN_DEBUG "%s: Data length is too long, length: '%ld', max: '%d'\n",
+            __func__, length, WRITER_BUFFER_SIZE);
+        return -E2BIG;
+    }
+
+    buffer = kvmalloc(length + 1, GFP_KERNEL);
+    if (buffer == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    if (copy_from_user(buffer, data, length) != 0)
+    {
+        printk(KERN_DEBUG "%s: Failed copy_from_user, UserAddress: '0x%p', Length: '%ld'\n",
+            __func__, data, length);
+        result = -EFAULT;
+        goto out;
+    }
+    buffer[length] = '\0';
+
+    // 값의 개수만큼만 할당하도록 먼저 공백으로 구분된 토큰을 셈
+    cursor = skip_spaces(buffer);
+    while (*cursor != '\0')
+    {
+        while (*cursor != '\0' && !isspace(*cursor))
+        {
+            cursor++;
+        }
+        cursor = skip_spaces(cursor);
+        tokens++;
+    }
+
+    if (tokens == 0)
+    {
+        printk(KERN_DEBUG "%s: Invaild argument, must input integers", __func__);
+        result = -EINVAL;
+        goto out;
+    }
+
+    items = kvmalloc_array(tokens, sizeof(*items), GFP_KERNEL);
+    itemTokens = kvmalloc_array(tokens, sizeof(*itemTokens), GFP_KERNEL);
+    if (items == NULL || itemTokens == NULL)
+    {
+        result = -ENOMEM;
+        goto out;
+    }
+
+    // 공백으로 구분된 정수들을 모두 해석한 뒤에 Enqueue
+    cursor = skip_spaces(buffer);
+    while (*cursor != '\0')
+    {
+        token = cursor;
+        while (*cursor != '\0' && !isspace(*cursor))
+        {
+            cursor++;
+        }
+        itemTokens[count].End = cursor - buffer;
+        if (*cursor != '\0')
+        {
+            *cursor++ = '\0';
+        }
+
+        if (kstrtoint(token, 10, &items[count]) != 0)
+        {
+            printk(KERN_DEBUG "%s: Invaild argument, must input integers", __func__);
+            result = -EINVAL;
+            goto out;
+        }
+
+        cursor = skip_spaces(cursor);
+        parsed++;
+        itemTokens[count].Parsed = parsed;
+
+        // 필터가 있으면 필터가 받거나 바꾸거나 버리고, 없으면 입력값이 음수인지 검사
+        filtered = kb_filter_apply(&Filter, &items[count]);
+        if (filtered < 0)
+        {
+            printk(KERN_DEBUG "%s: Item cannot be negative value, item : '%d'\n", __func__, items[count]);
+            result = -EINVAL;
+            goto out;
+        }
+
+        if (filtered == KB_FILTER_DROPPED)
+        {
+            continue;
+        }
+
+        count++;
+    }
+
+    // 필터가 모두 버렸으면 넣을 값이 없음
+    accepted = count == 0 ? 0 : KboardEnqueueBatch(items, count);
+
+    // 필터가 버린 값도 넣은 것으로 셈, 마지막으로 넣은 값 뒤에 버린 값만 남았으면 모두 넣은 것
+    mutex_lock(&seq->lock);
+    writerResult->Pending = true;
+    writerResult->Accepted = accepted == count ? tokens : accepted == 0 ? 0 : itemTokens[accepted - 1].Parsed;
+    writerResult->Count = tokens;
+    mutex_unlock(&seq->lock);
+
+    if (count == 0)
+    {
+        result = length;
+        goto out;
+    }
+
+    // 링 버퍼가 가득찼는지 검사
+    if (accepted == 0)
+    {
+        printk(KERN_DEBUG "%s: Ring buffer is full, count: '%d'\n", __func__, KboardCount());
+        result = -EPERM;
+        goto out;
+    }
+
+    printk(KERN_DEBUG "%s: Enqueued '%d' of '%d' items\n", __func__, accepted, count);
+    result = accepted == count ? length : itemTokens[accepted - 1].End;
+
+out:
+    kvfree(itemTokens);
+    kvfree(items);
+    kvfree(buffer);
+
+    return result;
+}
+
+// Reader의 Read 인터페이스 관련 메서드들
+static int KboardReader_Open(struct inode * inode, struct file * file)
+{
+    printk(KERN_DEBUG "'%s'\n", __func__);
+    return single_open(file, KboardReader_Show, NULL);
+}
+
+// Reader: Read(), Kboard의 링 버퍼에 있는 무작위 값을 보여줌
+static int KboardReader_Show(struct seq_file * file, void * unused)
+{
+    int item;
+    unsigned int randomIndex;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    if (KboardSample(&randomIndex, &item) != 0)
+    {
+        seq_printf(file, "Kboard is empty\n");
+        return 0;
+    }
+
+    seq_printf(file, "Read random value from Kboard: index: '%d', value: '%d'\n",
+        randomIndex, item);
+
+    return 0;
+}
+
+// Counter의 Read 인터페이스 관련 메서드들
+static int KboardCounter_Open(struct inode * inode, struct file * file)
+{
+    printk(KERN_DEBUG "'%s'\n", __func__);
+    return single_open(file, KboardCounter_Show, NULL);
+}
+
+// Counter: Read(), Kboard의 링 버퍼에 들어있는 값의 개수를 보여줌
+static int KboardCounter_Show(struct seq_file * file, void * unused)
+{
+    printk(KERN_DEBUG "'%s'\n", __func__);
+    seq_printf(file, "Kboard Count: '%d'\n", KboardCount());
+    return 0;
+}
+
+// Dumper의 Read 인터페이스 관련 메서드, 연 시점의 복사본을 페이지 단위로 나누어 출력
+static int KboardDumper_Open(struct inode * inode, struct file * file)
+{
+    struct KboardSnapshot *snapshot;
+    size_t size;
+    int result;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    snapshot = TakeSnapshot(&size);
+    if (snapshot == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    result = seq_open(file, &KBOARD_DUMPER_SEQ_OPERATIONS);
+    if (result != 0)
+    {
+        kvfree(snapshot);
+        return result;
+    }
+    ((struct seq_file *)file->private_data)->private = snapshot;
+
+    return 0;
+}
+
+static void *KboardDumper_Start(struct seq_file * file, loff_t * position)
+{
+    struct KboardSnapshot *snapshot = file->private;
+
+    if (*position > snapshot->Header.Capacity + 1)
+    {
+        return NULL;
+    }
+
+    return position;
+}
+
+static void *KboardDumper_Next(struct seq_file * file, void * value, loff_t * position)
+{
+    (*position)++;
+    return KboardDumper_Start(file, position);
+}
+
+static void KboardDumper_Stop(struct seq_file * file, void * value)
+{
+}
+
+// Dumper: Read(), Kboard의 상태, 사용중인 동기화 솔루션 종류, Writer, Reader의 수행 횟수 출력
+static int KboardDumper_Show(struct seq_file * file, void * value)
+{
+    struct KboardSnapshot *snapshot = file->private;
+    struct KboardSnapshotHeader *header = &snapshot->Header;
+    loff_t position = *(loff_t *)value;
+
+    if (position == 0)
+    {
+        seq_printf(file, "====== Kboard Status ======\n");
+        seq_printf(file, "[RingBuffer]\n");
+    }
+    else if (position <= header->Capacity)
+    {
+        seq_printf(file, "index: '%lld', value: '%d'\n", position - 1, snapshot->Items[position - 1]);
+    }
+    else
+    {
+        seq_printf(file, "[Count: '%d']\n", header->Count);
+        seq_printf(file, "[CurrentIndex: '%d']\n", header->CurrentIndex);
+        seq_printf(file, "[Writer: '%llu' times, Reader: '%llu' times]\n", header->PerformWriter, header->PerformReader);
+        seq_printf(file, "[Synchronization Solution: '%d']\n", header->SyncSolution);
+
+        // 백로그는 복사본에 포함되지 않으므로 출력 시점의 값
+        spin_lock(&BacklogLock);
+        seq_printf(file, "[Backlog: '%d' items, '%d' chunks, '%zu' bytes, Shrinker dropped: '%llu']\n",
+            BacklogCount, BacklogChunks, BacklogChunks * sizeof(struct KboardBacklogChunk), BacklogDropped);
+        spin_unlock(&BacklogLock);
+
+        // 중복 제거 저장소, 값을 칸에 int로 두었을 때와 비교한 순 절약 크기 (음수이면 더 사용)
+        // 칸마다 int 대신 포인터, 값마다 할당된 KboardPayload (해시 노드 포함), 해시 테이블의 버킷 배열을 모두 포함
+        if (dedup)
+        {
+            u64 lookups = READ_ONCE(DedupLookups);
+            u64 hits = READ_ONCE(DedupHits);
+            u64 references = READ_ONCE(DedupReferences);
+            u64 unique = atomic_read(&PayloadTable.nelems);
+            u64 store = READ_ONCE(DedupStoreBytes);
+            u64 buckets;
+            s64 saved;
+
+            rcu_read_lock();
+            buckets = rcu_dereference(PayloadTable.tbl)->size * sizeof(struct rhash_head *);
+            rcu_read_unlock();
+
+            saved = (s64)(references * sizeof(int)) - (s64)(references * sizeof(struct KboardPayload *) + store + buckets);
+
+            seq_printf(file, "[Dedup: lookups '%llu', hits '%llu', hit rate '%llu.%02llu%%']\n",
+                lookups, hits, lookups == 0 ? 0 : hits * 100 / lookups, lookups == 0 ? 0 : hits * 10000 / lookups % 100);
+            seq_printf(file, "[Dedup: references '%llu', unique '%llu', store '%llu' bytes, buckets '%llu' bytes, saved '%lld' bytes]\n",
+                references, unique, store, buckets, saved);
+        }
+
+        seq_printf(file, "===========================\n");
+    }
+
+    return 0;
+}
+
+static int KboardDumper_Release(struct inode * inode, struct file * file)
+{
+    kvfree(((struct seq_file *)file->private_data)->private);
+
+    return seq_release(inode, file);
+}
+
+// Waits의 Read, Write 인터페이스 관련 메서드
+static int KboardWaits_Open(struct inode * inode, struct file * file)
+{
+    printk(KERN_DEBUG "'%s'\n", __func__);
+    return single_open(file, KboardWaits_Show, NULL);
+}
+
+// Waits: Read(), 역할별 대기 시간 분포와 Task별 대기 시간 합계 출력, WaitReport가 읽는 형식
+// CPU별 측정값을 합친 뒤 출력하므로 출력하는 동안 Critical Section에 진입하는 경로를 막지 않음
+static int KboardWaits_Show(struct seq_file * file, void * unused)
+{
+    static const char *ROLE_NAME[WAIT_ROLE_COUNT] = { "writer", "reader" };
+    struct WaitCpuStat *total;
+    struct WaitStat *stat;
+    struct WaitTaskStat *task;
+    int role;
+    int index;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    total = kvzalloc(sizeof(*total), GFP_KERNEL);
+    if (total == NULL)
+    {
+        return -ENOMEM;
+    }
+    FoldWaitStat(total);
+
+    seq_printf(file, "sync_solution %d\n", SYNC_SOLUTION);
+    seq_printf(file, "tasks %d overflow %llu\n", total->TaskCount, total->TaskOverflow);
+
+    for (role = 0; role < WAIT_ROLE_COUNT; role++)
+    {
+        stat = &total->Roles[role];
+        seq_printf(file, "role %s count %llu total_ns %llu max_ns %llu\n",
+            ROLE_NAME[role], stat->Count, stat->TotalNs, stat->MaxNs);
+
+        seq_printf(file, "histogram %s", ROLE_NAME[role]);
+        for (index = 0; index < WAIT_HISTOGRAM_SIZE; index++)
+        {
+            seq_printf(file, " %llu", stat->Histogram[index]);
+        }
+        seq_printf(file, "\n");
+    }
+
+    for (index = 0; index < WAIT_TASK_MAX; index++)
+    {
+        task = &total->Tasks[index];
+        if (task->Count == 0)
+        {
+            continue;
+        }
 
-    LeaveCriticalSection_Writer();
+        seq_printf(file, "task %d %s count %llu total_ns %llu max_ns %llu\n",
+            task->Pid, ROLE_NAME[task->Role], task->Count, task->TotalNs, task->MaxNs);
+    }
+
+    kvfree(total);
+
+    return 0;
+}
+
+// Waits: Write(), 아무 값이나 쓰면 측정값을 초기화
+static ssize_t KboardWaits_Write(struct file * file, const char __user * data, size_t length, loff_t * off)
+{
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    ResetWaitStat();
 
     return length;
 }
 
-// Reader의 Read 인터페이스 관련 메서드들
-static int KboardReader_Open(struct inode * inode, struct file * file)
+// Drain, Sampler가 함께 사용하는 Open, Write, Release 메서드들
+static int KboardBatch_Open(struct file * file, int (*show)(struct seq_file *, void *), int limit)
+{
+    struct KboardBatch *batch;
+    int result;
+
+    batch = kzalloc(sizeof(*batch), GFP_KERNEL);
+    if (batch == NULL)
+    {
+        return -ENOMEM;
+    }
+    batch->Limit = limit;
+
+    result = single_open(file, show, batch);
+    if (result != 0)
+    {
+        kfree(batch);
+    }
+
+    return result;
+}
+
+// 가져온 값들을 버리고 다음 Show에서 다시 가져오도록 함, seq_file의 lock을 잡은 상태에서 호출
+static void KboardBatch_Reset(struct KboardBatch *batch)
+{
+    kfree(batch->Items);
+    batch->Items = NULL;
+    batch->Count = 0;
+    batch->Done = false;
+}
+
+// Drain, Sampler: Read(), offset 0 에서 시작하는 Read마다 (lseek, pread 포함) 새로 가져옴
+// 이어서 읽는 Read는 이미 가져온 값들을 계속 출력
+static ssize_t KboardBatch_Read(struct file * file, char __user * data, size_t length, loff_t * off)
+{
+    struct seq_file *seq = file->private_data;
+
+    if (*off == 0)
+    {
+        mutex_lock(&seq->lock);
+        KboardBatch_Reset(seq->private);
+        mutex_unlock(&seq->lock);
+    }
+
+    return seq_read(file, data, length, off);
+}
+
+// Drain, Sampler: Write(), 이 파일에서 한 번에 가져올 최대 개수를 설정하고 다음 Read에서 다시 가져오도록 함
+// 같은 파일로 다시 가져올 때는 offset 0 에서 읽어야 함 (lseek 또는 pread)
+static ssize_t KboardBatch_Write(struct file * file, const char __user * data, size_t length, loff_t * off)
 {
+    struct seq_file *seq = file->private_data;
+    struct KboardBatch *batch = seq->private;
+    int limit;
+    int result;
+
     printk(KERN_DEBUG "'%s'\n", __func__);
-    return single_open(file, KboardReader_Show, NULL);
+
+    result = kstrtoint_from_user(data, length, 10, &limit);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    if (limit <= 0)
+    {
+        printk(KERN_DEBUG "%s: Limit must be positive, limit: '%d'\n", __func__, limit);
+        return -EINVAL;
+    }
+
+    // 같은 파일에서 실행 중인 Read가 Items를 출력하고 있을 수 있으므로 seq_file의 lock 안에서 바꿈
+    mutex_lock(&seq->lock);
+    KboardBatch_Reset(batch);
+    batch->Limit = limit;
+    mutex_unlock(&seq->lock);
+
+    return length;
 }
 
-// Reader: Read(), Kboard의 링 버퍼에 있는 무작위 값을 보여줌
-static int KboardReader_Show(struct seq_file * file, void * unused)
+static int KboardBatch_Release(struct inode * inode, struct file * file)
 {
-    int item;
-    unsigned int randomIndex;
+    struct KboardBatch *batch = ((struct seq_file *)file->private_data)->private;
+
+    kfree(batch->Items);
+    kfree(batch);
+
+    return single_release(inode, file);
+}
+
+// 가져온 값들을 공백으로 구분해 한 줄로 출력, 가져온 값이 없으면 아무것도 출력하지 않음
+static void KboardBatch_Print(struct seq_file * file)
+{
+    struct KboardBatch *batch = file->private;
+    int index;
+
+    if (batch->Count == 0)
+    {
+        return;
+    }
+
+    for (index = 0; index < batch->Count; index++)
+    {
+        seq_put_decimal_ll(file, index == 0 ? "" : " ", batch->Items[index]);
+    }
+    seq_putc(file, '\n');
+}
 
+// Drain의 Read 인터페이스 관련 메서드들
+static int KboardDrain_Open(struct inode * inode, struct file * file)
+{
     printk(KERN_DEBUG "'%s'\n", __func__);
+    return KboardBatch_Open(file, KboardDrain_Show, READ_ONCE(capacity));
+}
 
-    get_random_bytes(&randomIndex, sizeof(randomIndex));
-    randomIndex = randomIndex % RING_BUFFER_SIZE;
+// Drain: Read(), 한 번의 Critical Section 안에서 최대 Limit 개를 Dequeue하고 공백으로 구분해 출력
+static int KboardDrain_Show(struct seq_file * file, void * unused)
+{
+    struct KboardBatch *batch = file->private;
+    int limit = min(batch->Limit, READ_ONCE(capacity));
 
-    EnterCriticalSection_Reader();
-	mdelay(PerformDelay);
-    PerformReader++;
+    printk(KERN_DEBUG "'%s'\n", __func__);
 
-    item = RingBuffer[randomIndex];
-    
-    LeaveCriticalSection_Reader();
+    if (!batch->Done)
+    {
+        if (batch->Items == NULL)
+        {
+            batch->Items = kmalloc_array(limit, sizeof(int), GFP_KERNEL);
+            if (batch->Items == NULL)
+            {
+                return -ENOMEM;
+            }
+        }
 
-    seq_printf(file, "Read random value from Kboard: index: '%d', value: '%d'\n",
-        randomIndex, item);
+        batch->Count = KboardDequeueBatch(batch->Items, limit);
+        batch->Done = true;
+    }
+
+    KboardBatch_Print(file);
 
     return 0;
 }
 
-// Counter의 Read 인터페이스 관련 메서드들
-static int KboardCounter_Open(struct inode * inode, struct file * file)
+// Sampler의 Read 인터페이스 관련 메서드들
+static int KboardSampler_Open(struct inode * inode, struct file * file)
 {
     printk(KERN_DEBUG "'%s'\n", __func__);
-    return single_open(file, KboardCounter_Show, NULL);
+    return KboardBatch_Open(file, KboardSampler_Show, 1);
 }
 
-// Counter: Read(), Kboard의 링 버퍼에 들어있는 값의 개수를 보여줌
-static int KboardCounter_Show(struct seq_file * file, void * unused)
+// Sampler: Read(), 한 번의 Critical Section 안에서 값이 들어있는 칸을 Limit 개 무작위로 읽어 출력
+static int KboardSampler_Show(struct seq_file * file, void * unused)
 {
+    struct KboardBatch *batch = file->private;
+    int limit = min(batch->Limit, SAMPLER_MAX);
+
     printk(KERN_DEBUG "'%s'\n", __func__);
-    seq_printf(file, "Kboard Count: '%d'\n", RingBufferCount);
+
+    if (!batch->Done)
+    {
+        if (batch->Items == NULL)
+        {
+            batch->Items = kmalloc_array(limit, sizeof(int), GFP_KERNEL);
+            if (batch->Items == NULL)
+            {
+                return -ENOMEM;
+            }
+        }
+
+        batch->Count = KboardSampleBatch(batch->Items, NULL, limit);
+        batch->Done = true;
+    }
+
+    KboardBatch_Print(file);
+
     return 0;
 }
 
-// Dumper의 Read 인터페이스 관련 메서드
-static int KboardDumper_Open(struct inode * inode, struct file * file)
+// Snapshot의 Read 인터페이스 관련 메서드, 연 시점의 복사본을 이진 형식으로 출력
+static int KboardSnapshot_Open(struct inode * inode, struct file * file)
+{
+    struct KboardSnapshot *snapshot;
+    size_t size;
+
+    printk(KERN_DEBUG "'%s'\n", __func__);
+
+    snapshot = TakeSnapshot(&size);
+    if (snapshot == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    file->private_data = snapshot;
+
+    return 0;
+}
+
+// Snapshot: Read(), KboardSnapshotHeader와 칸 값들을 그대로 복사
+static ssize_t KboardSnapshot_Read(struct file * file, char __user * data, size_t length, loff_t * off)
+{
+    struct KboardSnapshot *snapshot = file->private_data;
+
+    return simple_read_from_buffer(data, length, off, snapshot,
+        sizeof(snapshot->Header) + sizeof(int) * snapshot->Header.Capacity);
+}
+
+static int KboardSnapshot_Release(struct inode * inode, struct file * file)
+{
+    kvfree(file->private_data);
+
+    return 0;
+}
+
+// Capacity의 Read, Write 인터페이스 관련 메서드
+static int KboardCapacity_Open(struct inode * inode, struct file * file)
 {
     printk(KERN_DEBUG "'%s'\n", __func__);
-    return single_open(file, KboardDumper_Show, NULL);
+    return single_open(file, KboardCapacity_Show, NULL);
 }
 
-// Dumper: Read(), Kboard의 상태, 사용중인 동기화 솔루션 종류, Writer, Reader의 수행 횟수 출력
-static int KboardDumper_Show(struct seq_file * file, void * unused)
+// Capacity: Read(), 링 버퍼의 현재 용량을 보여줌
+static int KboardCapacity_Show(struct seq_file * file, void * unused)
 {
-    int index;
+    seq_printf(file, "Kboard Capacity: '%d'\n", READ_ONCE(capacity));
+    return 0;
+}
+
+// Capacity: Write(), 링 버퍼의 용량을 변경, 값을 버리지 않고 옮기므로 저장된 값의 개수보다 작게 줄일 수 없음
+static ssize_t KboardCapacity_Write(struct file * file, const char __user * data, size_t length, loff_t * off)
+{
+    int newCapacity;
+    int result;
 
     printk(KERN_DEBUG "'%s'\n", __func__);
-    
-    seq_printf(file, "====== Kboard Status ======\n");
-    seq_printf(file, "[RingBuffer]\n");
-    for (index = 0; index < RING_BUFFER_SIZE; index++)
+
+    result = kstrtoint_from_user(data, length, 10, &newCapacity);
+    if (result != 0)
     {
-        seq_printf(file, "index: '%d', value: '%d'\n", index, RingBuffer[index]);
+        return result;
     }
-    seq_printf(file, "[Count: '%d']\n", RingBufferCount);
-    seq_printf(file, "[CurrentIndex: '%d']\n", RingBufferCurrentIndex);
-    seq_printf(file, "[Writer: '%d' times, Reader: '%d' times]\n", PerformWriter, PerformReader);
-    seq_printf(file, "[Synchronization Solution: '%d']\n", SYNC_SOLUTION);
-    seq_printf(file, "===========================\n");
-    
-    return 0;
+
+    result = KboardResize(newCapacity);
+    if (result != 0)
+    {
+        printk(KERN_DEBUG "%s: Failed to resize, capacity: '%d', result: '%d'\n", __func__, newCapacity, result);
+        return result;
+    }
+
+    return length;
+}
+
+// Device: Read(), 요청한 크기만큼 값을 Dequeue해 __s32 배열로 돌려줌, 비어 있으면 0
+// splice로 파이프에 넘길 때도 generic_file_splice_read가 파이프 페이지를 iov_iter로 넘겨 같은 경로를 사용
+// Critical Section은 DEVICE_IO_BATCH 개마다 다시 진입하여 큰 요청이 다른 Writer, Reader를 오래 막지 않음
+static ssize_t KboardDevice_ReadIter(struct kiocb * iocb, struct iov_iter * to)
+{
+    ssize_t length = 0;
+    int error = 0;
+    int count;
+    int taken;
+
+    if (iov_iter_count(to) < sizeof(int))
+    {
+        return -EINVAL;
+    }
+
+    while (iov_iter_count(to) >= sizeof(int))
+    {
+        count = min_t(size_t, iov_iter_count(to) / sizeof(int), DEVICE_IO_BATCH);
+        taken = KboardDequeueIter(to, count, &error);
+        length += taken * sizeof(int);
+        if (taken < count)
+        {
+            break;
+        }
+    }
+
+    return length > 0 ? length : error;
+}
+
+// Device: Write(), __s32 배열의 값들을 Enqueue하고 넣은 만큼의 바이트 수를 반환, 4 바이트가 안 되는 나머지는 무시
+// splice로 파이프에서 받을 때도 iter_file_splice_write가 파이프 페이지를 iov_iter로 넘겨 같은 경로를 사용하고 넣은 만큼만 파이프에서 소비
+// 하나도 넣지 못하면 음수 값은 -EINVAL, 링 버퍼와 백로그가 가득 찼으면 -ENOSPC
+static ssize_t KboardDevice_WriteIter(struct kiocb * iocb, struct iov_iter * from)
+{
+    ssize_t length = 0;
+    int error = 0;
+    int count;
+    int accepted;
+
+    if (iov_iter_count(from) < sizeof(int))
+    {
+        return -EINVAL;
+    }
+
+    while (iov_iter_count(from) >= sizeof(int))
+    {
+        count = min_t(size_t, iov_iter_count(from) / sizeof(int), DEVICE_IO_BATCH);
+        accepted = KboardEnqueueIter(from, count, &error);
+        length += accepted * sizeof(int);
+        if (accepted < count)
+        {
+            break;
+        }
+    }
+
+    return length > 0 ? length : error;
+}
+
+// Device: mmap(), 링 버퍼의 미러(struct KboardShared)를 읽기 전용으로 매핑
+// Reader는 세마포어, 시스템 콜 없이 Sequence를 확인하며 칸을 직접 읽음
+static int KboardDevice_Mmap(struct file * file, struct vm_area_struct * vma)
+{
+    if (vma->vm_flags & VM_WRITE)
+    {
+        return -EPERM;
+    }
+    vma->vm_flags &= ~VM_MAYWRITE;
+
+    return remap_vmalloc_range(vma, Shared, vma->vm_pgoff);
+}
+
+// Device: KBOARD_IOC_SAMPLE_BATCH, 요청한 개수만큼 무작위로 읽어 Count와 Items를 채움
+static long KboardDevice_SampleBatch(struct KboardSampleBatch __user *userBatch)
+{
+    struct KboardSampleBatch *batch;
+    int count;
+    long result = 0;
+
+    if (get_user(count, &userBatch->Count) != 0)
+    {
+        return -EFAULT;
+    }
+    if (count <= 0 || count > KBOARD_SAMPLE_MAX)
+    {
+        return -EINVAL;
+    }
+
+    batch = kmalloc(sizeof(*batch), GFP_KERNEL);
+    if (batch == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    batch->Count = KboardSampleBatch(batch->Items, NULL, count);
+    if (batch->Count == 0)
+    {
+        result = -ENODATA;
+    }
+    else if (copy_to_user(userBatch, batch, offsetof(struct KboardSampleBatch, Items[batch->Count])) != 0)
+    {
+        result = -EFAULT;
+    }
+
+    kfree(batch);
+
+    return result;
+}
+
+// Device: ioctl(), 고정 크기 구조체로 Enqueue, Dequeue, 무작위 읽기, 상태 조회를 수행
+static long KboardDevice_Ioctl(struct file * file, unsigned int command, unsigned long argument)
+{
+    void __user *userAddress = (void __user *)argument;
+    struct KboardItem item;
+    struct KboardSample sample;
+    struct KboardStatus status;
+    struct KboardRing *ring;
+    struct sock_fprog fprog;
+    unsigned int index;
+    int result;
+
+    switch (command)
+    {
+    case KBOARD_IOC_ENQUEUE:
+        if (copy_from_user(&item, userAddress, sizeof(item)) != 0)
+        {
+            return -EFAULT;
+        }
+        return KboardEnqueue(item.Item);
+
+    case KBOARD_IOC_DEQUEUE:
+        result = KboardDequeue(&item.Item);
+        if (result != 0)
+        {
+            return result;
+        }
+        // 복사에 실패하면 꺼낸 값은 사라지므로 -EFAULT로 알려줌
+        if (copy_to_user(userAddress, &item, sizeof(item)) != 0)
+        {
+            return -EFAULT;
+        }
+        return 0;
+
+    case KBOARD_IOC_SAMPLE:
+        result = KboardSample(&index, &sample.Item);
+        if (result != 0)
+        {
+            return result;
+        }
+        sample.Index = index;
+        if (copy_to_user(userAddress, &sample, sizeof(sample)) != 0)
+        {
+            return -EFAULT;
+        }
+        return 0;
+
+    case KBOARD_IOC_SAMPLE_BATCH:
+        return KboardDevice_SampleBatch(userAddress);
+
+    case KBOARD_IOC_SET_FILTER:
+        // 모든 Writer의 Enqueue에 적용되므로 관리자만 바꿀 수 있음
+        if (!capable(CAP_SYS_ADMIN))
+        {
+            return -EPERM;
+        }
+        if (userAddress == NULL)
+        {
+            return kb_filter_replace(&Filter, NULL, &FilterLock);
+        }
+        if (copy_from_user(&fprog, userAddress, sizeof(fprog)) != 0)
+        {
+            return -EFAULT;
+        }
+        return kb_filter_replace(&Filter, &fprog, &FilterLock);
+
+    case KBOARD_IOC_STATUS:
+        rcu_read_lock();
+        ring = rcu_dereference(RingBuffer);
+        status.Count = ring->Count;
+        status.Capacity = ring->Capacity;
+        status.CurrentIndex = ring->CurrentIndex;
+        rcu_read_unlock();
+        status.SyncSolution = SYNC_SOLUTION;
+        status.PerformWriter = PerformWriter;
+        status.PerformReader = PerformReader;
+        if (copy_to_user(userAddress, &status, sizeof(status)) != 0)
+        {
+            return -EFAULT;
+        }
+        return 0;
+
+    default:
+        return -ENOTTY;
+    }
+}
+
+#ifdef CONFIG_COMPAT
+// 32비트 프로세스의 struct sock_fprog는 크기와 포인터 폭이 달라 명령 번호도 다름
+#define KBOARD_IOC_SET_FILTER32 _IOW(KBOARD_IOCTL_MAGIC, 6, struct compat_sock_fprog)
+
+// Device: 32비트 프로세스의 ioctl(), 필터는 struct compat_sock_fprog를 변환하고
+// 나머지 명령의 구조체는 고정 크기 타입만 사용하여 배치가 같으므로 주소만 바꿔 그대로 처리
+static long KboardDevice_CompatIoctl(struct file * file, unsigned int command, unsigned long argument)
+{
+    struct compat_sock_fprog compatFprog;
+    struct sock_fprog fprog;
+
+    if (command != KBOARD_IOC_SET_FILTER32)
+    {
+        return KboardDevice_Ioctl(file, command, (unsigned long)compat_ptr(argument));
+    }
+
+    if (!capable(CAP_SYS_ADMIN))
+    {
+        return -EPERM;
+    }
+
+    if (argument == 0)
+    {
+        return kb_filter_replace(&Filter, NULL, &FilterLock);
+    }
+
+    if (copy_from_user(&compatFprog, compat_ptr(argument), sizeof(compatFprog)) != 0)
+    {
+        return -EFAULT;
+    }
+    fprog.len = compatFprog.len;
+    fprog.filter = compat_ptr(compatFprog.filter);
+
+    return kb_filter_replace(&Filter, &fprog, &FilterLock);
 }
+#endif
 
 // 모듈 초기화 메서드
 static int __init KboardModuleInit(void)
 {
     printk(KERN_DEBUG "'%s'\n", __func__);
     
-    InitializeKboard();
+    if (InitializeKboard() != 0)
+    {
+        return -1;
+    }
     InitializeSyncSolution();
-    return InitializeProc();
+
+    if (rhashtable_init(&PayloadTable, &PAYLOAD_TABLE_PARAMS) != 0)
+    {
+        printk("Failed to create dedup store\n");
+        DestroyKboard();
+        return -1;
+    }
+
+    if (genl_register_family(&KboardFamily) != 0)
+    {
+        printk("Failed to register generic netlink family %s\n", KBOARD_GENL_NAME);
+        rhashtable_destroy(&PayloadTable);
+        DestroyKboard();
+        return -1;
+    }
+
+    if (InitializeProc() != 0)
+    {
+        genl_unregister_family(&KboardFamily);
+        rhashtable_destroy(&PayloadTable);
+        DestroyKboard();
+        return -1;
+    }
+
+    if (InitializeDevice() != 0)
+    {
+        DestroyProc();
+        genl_unregister_family(&KboardFamily);
+        rhashtable_destroy(&PayloadTable);
+        DestroyKboard();
+        return -1;
+    }
+
+    if (register_shrinker(&KboardShrinker) != 0)
+    {
+        printk("Failed to register shrinker\n");
+        DestroyDevice();
+        DestroyProc();
+        genl_unregister_family(&KboardFamily);
+        rhashtable_destroy(&PayloadTable);
+        DestroyKboard();
+        return -1;
+    }
+
+    return 0;
 }
 
 // 모듈 삭제 메서드
@@ -583,7 +2651,15 @@ static void __exit KboardModuleExit(void)
 {
     printk(KERN_DEBUG "'%s'\n", __func__);
 
+    unregister_shrinker(&KboardShrinker);
+    DestroyDevice();
     DestroyProc();
+    cancel_delayed_work_sync(&NotifyWork);
+    genl_unregister_family(&KboardFamily);
+    DestroyBacklog();
+    DestroyKboard();
+    rhashtable_free_and_destroy(&PayloadTable, KboardPayload_Free, NULL);
+    kb_filter_replace(&Filter, NULL, &FilterLock);
 }
 
 module_init(KboardModuleInit);
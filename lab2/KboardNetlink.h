@@ -0,0 +1,31 @@
+#ifndef KBOARD_NETLINK_H
+#define KBOARD_NETLINK_H
+
+// Kboard 의 Generic Netlink 인터페이스, 커널 모듈과 유저 프로그램이 함께 사용
+// 링 버퍼에 새로 들어온 값들을 "clips" 멀티캐스트 그룹에 알림
+// 짧은 시간(notify_window_us) 동안 들어온 값들을 모아 하나의 KBOARD_CMD_CLIPS 메시지로 보냄
+//   KBOARD_ATTR_ITEMS  : 들어온 순서대로의 __s32 값 배열
+//   KBOARD_ATTR_DROPPED: 모으는 버퍼가 가득 차 이전 메시지 이후 알리지 못한 값의 개수 (__u32), 0 이면 생략
+
+#define KBOARD_GENL_NAME "KBOARD"
+#define KBOARD_GENL_VERSION 1
+#define KBOARD_GENL_GROUP "clips"
+
+enum
+{
+    KBOARD_CMD_UNSPEC,
+    KBOARD_CMD_CLIPS,
+    __KBOARD_CMD_MAX,
+};
+#define KBOARD_CMD_MAX (__KBOARD_CMD_MAX - 1)
+
+enum
+{
+    KBOARD_ATTR_UNSPEC,
+    KBOARD_ATTR_ITEMS,
+    KBOARD_ATTR_DROPPED,
+    __KBOARD_ATTR_MAX,
+};
+#define KBOARD_ATTR_MAX (__KBOARD_ATTR_MAX - 1)
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef KBOARD_SYNC_H
+#define KBOARD_SYNC_H
+
+// Readers-Writers Problem 솔루션 1 ~ 3
+// 커널 모듈(KboardModule.c)과 유저 공간 시뮬레이터(sim/)가 함께 사용
+// 포함하기 전에 SYNC_SOLUTION, struct semaphore, down(), up(), InitializeSemaphore()가 정의되어 있어야 함
+
+#ifndef SYNC_SOLUTION
+#error "SYNC_SOLUTION must be defined before including KboardSync.h"
+#endif
+
+// Readers-Writers Problem 솔루션에서 사용할 솔루션 종류별 변수들
+#if SYNC_SOLUTION == 1
+static struct semaphore SemaphoreMutex;
+static struct semaphore SemaphoreWriter;
+static int ReaderCount;
+
+#elif SYNC_SOLUTION == 2
+static struct semaphore SemaphoreWriterMutex;
+static struct semaphore SemaphoreReaderMutex;
+static struct semaphore SemaphoreWriter;
+static struct semaphore SemaphoreReader;
+static int WriterCount;
+static int ReaderCount;
+
+#elif SYNC_SOLUTION == 3
+static struct semaphore SemaphoreMutex;
+static struct semaphore SemaphoreWriter;
+static struct semaphore SemaphoreReader;
+static int WriterCount;
+static int ReaderCount;
+static int WriterWaitingCount;
+static int ReaderWaitingCount;
+#endif
+
+// 솔루션별 Critical Section 안에서 수행할 작업 시간 (ms)
+static int PerformDelay;
+
+// SYNC_SOLUTION에 따라 각 솔루션에 필요한 변수 초기값 설정
+static void InitializeSyncSolution(void)
+{
+#if SYNC_SOLUTION == 1
+    InitializeSemaphore(&SemaphoreMutex, 1);
+    InitializeSemaphore(&SemaphoreWriter, 1);
+    ReaderCount = 0;
+    PerformDelay = 3;
+
+#elif SYNC_SOLUTION == 2
+    InitializeSemaphore(&SemaphoreWriterMutex, 1);
+    InitializeSemaphore(&SemaphoreReaderMutex, 1);
+    InitializeSemaphore(&SemaphoreWriter, 1);
+    InitializeSemaphore(&SemaphoreReader, 1);
+    WriterCount = 0;
+    ReaderCount = 0;
+    PerformDelay = 1;
+
+#elif SYNC_SOLUTION == 3
+    InitializeSemaphore(&SemaphoreMutex, 1);
+    InitializeSemaphore(&SemaphoreWriter, 0);
+    InitializeSemaphore(&SemaphoreReader, 0);
+    WriterCount = 0;
+    ReaderCount = 0;
+    WriterWaitingCount = 0;
+    ReaderWaitingCount = 0;
+    PerformDelay = 1;
+#endif
+}
+
+// Writer가 CriticalSection에 진입하기위해 Lock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
+static void EnterCriticalSection_Writer(void)
+{
+#if SYNC_SOLUTION == 1
+    down(&SemaphoreWriter);
+
+#elif SYNC_SOLUTION == 2
+    down(&SemaphoreWriterMutex);
+    WriterCount++;
+    if (WriterCount == 1)
+    {
+        down(&SemaphoreReader);
+    }
+    up(&SemaphoreWriterMutex);
+    down(&SemaphoreWriter);
+
+#elif SYNC_SOLUTION == 3
+    down(&SemaphoreMutex);
+    if (WriterCount > 0 || ReaderCount > 0 ||
+        WriterWaitingCount > 0 || ReaderWaitingCount > 0)
+    {
+        WriterWaitingCount++;
+        up(&SemaphoreMutex);
+        down(&SemaphoreWriter);
+        down(&SemaphoreMutex);
+        WriterWaitingCount--;
+    }
+    WriterCount++;
+    up(&SemaphoreMutex);
+#endif
+}
+
+// Reader가 CriticalSection에 진입하기위해 Lock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
+static void EnterCriticalSection_Reader(void)
+{
+#if SYNC_SOLUTION == 1
+    down(&SemaphoreMutex);
+    ReaderCount++;
+    if (ReaderCount == 1)
+    {
+        down(&SemaphoreWriter);
+    }
+    up(&SemaphoreMutex);
+
+#elif SYNC_SOLUTION == 2
+    down(&SemaphoreReader);
+    up(&SemaphoreReader);
+    down(&SemaphoreReaderMutex);
+    ReaderCount++;
+    if (ReaderCount == 1)
+    {
+        down(&SemaphoreWriter);
+    }
+    up(&SemaphoreReaderMutex);
+
+#elif SYNC_SOLUTION == 3
+    down(&SemaphoreMutex);
+    if (WriterWaitingCount > 0 || WriterCount > 0)
+    {
+        ReaderWaitingCount++;
+        up(&SemaphoreMutex);
+        down(&SemaphoreReader);
+        down(&SemaphoreMutex);
+        ReaderWaitingCount--;
+    }
+    ReaderCount++;
+    up(&SemaphoreMutex);
+#endif
+}
+
+// Writer가 CriticalSection으로부터 나가면서 Unlock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
+static void LeaveCriticalSection_Writer(void)
+{
+#if SYNC_SOLUTION == 1
+    up(&SemaphoreWriter);
+
+#elif SYNC_SOLUTION == 2
+    up(&SemaphoreWriter);
+    down(&SemaphoreWriterMutex);
+    WriterCount--;
+    if (WriterCount == 0)
+    {
+        up(&SemaphoreReader);
+    }
+    up(&SemaphoreWriterMutex);
+
+#elif SYNC_SOLUTION == 3
+    int index;
+
+    down(&SemaphoreMutex);
+    WriterCount--;
+    if (ReaderWaitingCount > 0)
+    {
+        for (index = 0; index < ReaderWaitingCount; index++)
+        {
+            up(&SemaphoreReader);
+        }
+    }
+    else if (WriterWaitingCount > 0)
+    {
+        up(&SemaphoreWriter);
+    }
+    up(&SemaphoreMutex);
+#endif
+}
+
+// Reader가 CriticalSection으로부터 나가면서 Unlock을 해주는 메서드, SYNC_SOLUTION에 따라 다르게 적용
+static void LeaveCriticalSection_Reader(void)
+{
+#if SYNC_SOLUTION == 1
+    down(&SemaphoreMutex);
+    ReaderCount--;
+    if (ReaderCount == 0)
+    {
+        up(&SemaphoreWriter);
+    }
+    up(&SemaphoreMutex);
+
+#elif SYNC_SOLUTION == 2
+    down(&SemaphoreReaderMutex);
+    ReaderCount--;
+    if (ReaderCount == 0)
+    {
+        up(&SemaphoreWriter);
+    }
+    up(&SemaphoreReaderMutex);
+
+#elif SYNC_SOLUTION == 3
+    down(&SemaphoreMutex);
+    ReaderCount--;
+    if (ReaderCount == 0 && WriterWaitingCount > 0)
+    {
+        up(&SemaphoreWriter);
+    }
+    up(&SemaphoreMutex);
+#endif
+}
+
+#endif
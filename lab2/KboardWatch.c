@@ -0,0 +1,200 @@
+#include "KboardNetlink.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+
+// Kboard 의 "clips" Generic Netlink 그룹을 구독하여 새로 들어온 값들을 출력
+// /proc/kboard/dump, /proc/kboard/count 를 주기적으로 읽지 않고 알림을 받음
+// libnl 없이 NETLINK_GENERIC 소켓으로 패밀리와 그룹 id 를 조회한 뒤 그룹에 가입
+
+#define BUFFER_SIZE 16384
+
+#define MESSAGE_ATTR(header) ((struct nlattr *)((char *)GENLMSG_DATA(header)))
+#define GENLMSG_DATA(header) ((char *)NLMSG_DATA(header) + GENL_HDRLEN)
+#define ATTR_DATA(attr) ((char *)(attr) + NLA_HDRLEN)
+#define ATTR_NEXT(attr) ((struct nlattr *)((char *)(attr) + NLA_ALIGN((attr)->nla_len)))
+#define ATTR_OK(attr, remain) ((remain) >= (int)sizeof(struct nlattr) && (attr)->nla_len >= sizeof(struct nlattr) && (attr)->nla_len <= (remain))
+
+// nlctrl 에 KBOARD 패밀리를 조회하여 패밀리 id 와 "clips" 그룹 id 를 얻음, 실패하면 -1
+static int ResolveFamily(int sock, int *familyId, int *groupId)
+{
+	static char buffer[BUFFER_SIZE];
+	struct
+	{
+		struct nlmsghdr Header;
+		struct genlmsghdr Generic;
+		char Attributes[64];
+	} request;
+	struct nlmsghdr *reply;
+	struct nlattr *attr;
+	struct nlattr *group;
+	struct nlattr *field;
+	int remain;
+	int groupRemain;
+	int fieldRemain;
+	int id;
+	const char *name;
+	ssize_t length;
+
+	memset(&request, 0, sizeof(request));
+	request.Header.nlmsg_type = GENL_ID_CTRL;
+	request.Header.nlmsg_flags = NLM_F_REQUEST;
+	request.Header.nlmsg_seq = 1;
+	request.Generic.cmd = CTRL_CMD_GETFAMILY;
+	request.Generic.version = 1;
+
+	attr = (struct nlattr *)request.Attributes;
+	attr->nla_type = CTRL_ATTR_FAMILY_NAME;
+	attr->nla_len = NLA_HDRLEN + sizeof(KBOARD_GENL_NAME);
+	memcpy(ATTR_DATA(attr), KBOARD_GENL_NAME, sizeof(KBOARD_GENL_NAME));
+	request.Header.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN + NLA_ALIGN(attr->nla_len));
+
+	if (send(sock, &request, request.Header.nlmsg_len, 0) < 0)
+	{
+		return -1;
+	}
+
+	length = recv(sock, buffer, sizeof(buffer), 0);
+	reply = (struct nlmsghdr *)buffer;
+	if (length < 0 || !NLMSG_OK(reply, length) || reply->nlmsg_type == NLMSG_ERROR)
+	{
+		errno = length < 0 ? errno : ENOENT;
+		return -1;
+	}
+
+	*familyId = -1;
+	*groupId = -1;
+	remain = reply->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+	for (attr = MESSAGE_ATTR(reply); ATTR_OK(attr, remain); remain -= NLA_ALIGN(attr->nla_len), attr = ATTR_NEXT(attr))
+	{
+		if (attr->nla_type == CTRL_ATTR_FAMILY_ID)
+		{
+			*familyId = *(__u16 *)ATTR_DATA(attr);
+		}
+		else if (attr->nla_type == CTRL_ATTR_MCAST_GROUPS)
+		{
+			// 그룹마다 중첩된 속성 안에 이름과 id 가 들어 있음
+			groupRemain = attr->nla_len - NLA_HDRLEN;
+			for (group = (struct nlattr *)ATTR_DATA(attr); ATTR_OK(group, groupRemain);
+				groupRemain -= NLA_ALIGN(group->nla_len), group = ATTR_NEXT(group))
+			{
+				id = -1;
+				name = NULL;
+				fieldRemain = group->nla_len - NLA_HDRLEN;
+				for (field = (struct nlattr *)ATTR_DATA(group); ATTR_OK(field, fieldRemain);
+					fieldRemain -= NLA_ALIGN(field->nla_len), field = ATTR_NEXT(field))
+				{
+					if (field->nla_type == CTRL_ATTR_MCAST_GRP_ID)
+					{
+						id = *(__u32 *)ATTR_DATA(field);
+					}
+					else if (field->nla_type == CTRL_ATTR_MCAST_GRP_NAME)
+					{
+						name = ATTR_DATA(field);
+					}
+				}
+				if (name != NULL && strcmp(name, KBOARD_GENL_GROUP) == 0)
+				{
+					*groupId = id;
+				}
+			}
+		}
+	}
+
+	if (*familyId < 0 || *groupId < 0)
+	{
+		errno = ENOENT;
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static char buffer[BUFFER_SIZE];
+	struct sockaddr_nl address;
+	struct nlmsghdr *message;
+	struct nlattr *attr;
+	int familyId;
+	int groupId;
+	int sock;
+	int remain;
+	int index;
+	ssize_t length;
+
+	sock = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+	if (sock < 0)
+	{
+		printf("Failed to open netlink socket: %s\n", strerror(errno));
+		return -1;
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.nl_family = AF_NETLINK;
+	if (bind(sock, (struct sockaddr *)&address, sizeof(address)) != 0)
+	{
+		printf("Failed to bind netlink socket: %s\n", strerror(errno));
+		close(sock);
+		return -1;
+	}
+
+	if (ResolveFamily(sock, &familyId, &groupId) != 0)
+	{
+		printf("Failed to resolve %s/%s (is the module loaded?): %s\n", KBOARD_GENL_NAME, KBOARD_GENL_GROUP, strerror(errno));
+		close(sock);
+		return -1;
+	}
+
+	if (setsockopt(sock, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &groupId, sizeof(groupId)) != 0)
+	{
+		printf("Failed to join %s: %s\n", KBOARD_GENL_GROUP, strerror(errno));
+		close(sock);
+		return -1;
+	}
+
+	printf("Watching %s/%s\n", KBOARD_GENL_NAME, KBOARD_GENL_GROUP);
+	fflush(stdout);
+
+	while ((length = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+	{
+		for (message = (struct nlmsghdr *)buffer; NLMSG_OK(message, length); message = NLMSG_NEXT(message, length))
+		{
+			if (message->nlmsg_type != familyId
+				|| ((struct genlmsghdr *)NLMSG_DATA(message))->cmd != KBOARD_CMD_CLIPS)
+			{
+				continue;
+			}
+
+			remain = message->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+			for (attr = MESSAGE_ATTR(message); ATTR_OK(attr, remain); remain -= NLA_ALIGN(attr->nla_len), attr = ATTR_NEXT(attr))
+			{
+				if (attr->nla_type == KBOARD_ATTR_ITEMS)
+				{
+					printf("Clips:");
+					for (index = 0; index < (int)((attr->nla_len - NLA_HDRLEN) / sizeof(__s32)); index++)
+					{
+						printf(" '%d'", ((__s32 *)ATTR_DATA(attr))[index]);
+					}
+					printf("\n");
+				}
+				else if (attr->nla_type == KBOARD_ATTR_DROPPED)
+				{
+					printf("Dropped: '%u'\n", *(__u32 *)ATTR_DATA(attr));
+				}
+			}
+		}
+		fflush(stdout);
+	}
+
+	printf("Failed to receive: %s\n", strerror(errno));
+	close(sock);
+
+	return -1;
+}
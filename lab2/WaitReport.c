@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// /proc/kboard/waits 를 읽어 역할별 대기 시간 분포, 최대 기아 시간, Jain's fairness index 를 CSV 로 출력
+
+#define WAITS_PATH "/proc/kboard/waits"
+#define ROLE_COUNT 2
+#define HISTOGRAM_SIZE 64
+#define LINE_SIZE 2048
+
+static const char *ROLE_NAME[ROLE_COUNT] = { "writer", "reader" };
+
+struct RoleStat
+{
+	unsigned long long count;
+	unsigned long long totalNs;
+	unsigned long long maxNs;
+	unsigned long long histogram[HISTOGRAM_SIZE];
+
+	// Jain's fairness index 계산을 위한 Task별 합계
+	int taskCount;
+	double opsSum, opsSquareSum;
+	double waitSum, waitSquareSum;
+};
+
+static int FindRole(const char *name)
+{
+	int role;
+
+	for (role = 0; role < ROLE_COUNT; role++)
+	{
+		if (strcmp(name, ROLE_NAME[role]) == 0)
+		{
+			return role;
+		}
+	}
+
+	return -1;
+}
+
+// 히스토그램에서 백분위수가 속한 칸의 상한 (ns), 최대 대기 시간을 넘지 않음
+static unsigned long long Percentile(const struct RoleStat *stat, double percentile)
+{
+	unsigned long long target = (unsigned long long)(percentile * stat->count);
+	unsigned long long seen = 0;
+	unsigned long long upper;
+	int index;
+
+	for (index = 0; index < HISTOGRAM_SIZE; index++)
+	{
+		seen += stat->histogram[index];
+		if (seen > target)
+		{
+			upper = index + 1 < HISTOGRAM_SIZE ? 1ULL << (index + 1) : stat->maxNs;
+			return upper < stat->maxNs ? upper : stat->maxNs;
+		}
+	}
+
+	return stat->maxNs;
+}
+
+// Jain's fairness index: (sum x)^2 / (n * sum x^2), 1 이면 완전히 공평
+static double Jain(int count, double sum, double squareSum)
+{
+	if (count == 0 || squareSum == 0)
+	{
+		return 1.0;
+	}
+
+	return (sum * sum) / (count * squareSum);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *path = argc > 1 ? argv[1] : WAITS_PATH;
+	struct RoleStat stats[ROLE_COUNT];
+	struct RoleStat *stat;
+	char line[LINE_SIZE];
+	char name[16];
+	char *cursor;
+	char *end;
+	int syncSolution = 0;
+	int pid;
+	int role;
+	int index;
+	unsigned long long count, totalNs, maxNs;
+	double meanWait;
+	FILE *file;
+
+	file = fopen(path, "r");
+	if (file == NULL)
+	{
+		printf("Failed to open '%s'\n", path);
+		return -1;
+	}
+
+	memset(stats, 0, sizeof(stats));
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		if (sscanf(line, "sync_solution %d", &syncSolution) == 1)
+		{
+			continue;
+		}
+
+		if (sscanf(line, "role %15s count %llu total_ns %llu max_ns %llu", name, &count, &totalNs, &maxNs) == 4)
+		{
+			role = FindRole(name);
+			if (role >= 0)
+			{
+				stats[role].count = count;
+				stats[role].totalNs = totalNs;
+				stats[role].maxNs = maxNs;
+			}
+			continue;
+		}
+
+		if (sscanf(line, "histogram %15s", name) == 1)
+		{
+			role = FindRole(name);
+			if (role < 0)
+			{
+				continue;
+			}
+
+			cursor = line + strlen("histogram ") + strlen(name);
+			for (index = 0; index < HISTOGRAM_SIZE; index++)
+			{
+				stats[role].histogram[index] = strtoull(cursor, &end, 10);
+				if (end == cursor)
+				{
+					break;
+				}
+				cursor = end;
+			}
+			continue;
+		}
+
+		if (sscanf(line, "task %d %15s count %llu total_ns %llu max_ns %llu", &pid, name, &count, &totalNs, &maxNs) == 5)
+		{
+			role = FindRole(name);
+			if (role < 0 || count == 0)
+			{
+				continue;
+			}
+
+			meanWait = (double)totalNs / count;
+			stat = &stats[role];
+			stat->taskCount++;
+			stat->opsSum += count;
+			stat->opsSquareSum += (double)count * count;
+			stat->waitSum += meanWait;
+			stat->waitSquareSum += meanWait * meanWait;
+		}
+	}
+
+	fclose(file);
+
+	// jain_ops: Task별 진입 횟수의 공평성, jain_wait: Task별 평균 대기 시간의 공평성
+	printf("sync_solution,role,count,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_starvation_ns,tasks,jain_ops,jain_wait\n");
+	for (role = 0; role < ROLE_COUNT; role++)
+	{
+		stat = &stats[role];
+		printf("%d,%s,%llu,%.1f,%llu,%llu,%llu,%llu,%llu,%d,%.4f,%.4f\n",
+			syncSolution, ROLE_NAME[role], stat->count,
+			stat->count > 0 ? (double)stat->totalNs / stat->count : 0.0,
+			Percentile(stat, 0.50), Percentile(stat, 0.90), Percentile(stat, 0.99), Percentile(stat, 0.999),
+			stat->maxNs, stat->taskCount,
+			Jain(stat->taskCount, stat->opsSum, stat->opsSquareSum),
+			Jain(stat->taskCount, stat->waitSum, stat->waitSquareSum));
+	}
+
+	return 0;
+}
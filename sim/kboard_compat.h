@@ -0,0 +1,95 @@
+#ifndef KBOARD_COMPAT_H
+#define KBOARD_COMPAT_H
+
+// 커널 코드에서 사용하는 동기화, 메모리 복사 함수를 pthread, libc 로 대응시킴
+// 공유 헤더(kboard_ring.h, kboard_stack.h, KboardSync.h)를 유저 공간에서 그대로 컴파일하기 위해 사용
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <string.h>
+#include <time.h>
+
+#define __user
+#define KERN_DEBUG ""
+#define printk(...) ((void)0)
+
+// 잠금 없는 자료구조(kboard_stack.h)에서 사용하는 원자적 연산 -> GCC 내장 함수
+#define READ_ONCE(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define WRITE_ONCE(x, value) __atomic_store_n(&(x), (value), __ATOMIC_RELAXED)
+#define cmpxchg64(pointer, old, new) __sync_val_compare_and_swap((pointer), (old), (new))
+
+// spinlock_t -> pthread_spinlock_t
+typedef pthread_spinlock_t spinlock_t;
+
+static inline void spin_lock_init(spinlock_t *lock)
+{
+	pthread_spin_init(lock, PTHREAD_PROCESS_PRIVATE);
+}
+
+static inline void spin_lock(spinlock_t *lock)
+{
+	pthread_spin_lock(lock);
+}
+
+static inline void spin_unlock(spinlock_t *lock)
+{
+	pthread_spin_unlock(lock);
+}
+
+// struct semaphore -> sem_t
+struct semaphore
+{
+	sem_t sem;
+};
+
+static inline void InitializeSemaphore(struct semaphore *sema, int value)
+{
+	sem_init(&sema->sem, 0, value);
+}
+
+static inline void down(struct semaphore *sema)
+{
+	while (sem_wait(&sema->sem) != 0)
+	{
+	}
+}
+
+static inline void up(struct semaphore *sema)
+{
+	sem_post(&sema->sem);
+}
+
+// mdelay()는 커널에서 바쁜 대기를 하므로 유저 공간에서도 CPU 를 점유하며 기다림
+static inline void mdelay(unsigned int milliseconds)
+{
+	struct timespec now, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += milliseconds / 1000;
+	end.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+	if (end.tv_nsec >= 1000000000L)
+	{
+		end.tv_sec++;
+		end.tv_nsec -= 1000000000L;
+	}
+
+	do
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+	} while (now.tv_sec < end.tv_sec || (now.tv_sec == end.tv_sec && now.tv_nsec < end.tv_nsec));
+}
+
+// 유저 공간에서는 주소 공간이 같으므로 단순 복사, 실패하지 않음
+static inline unsigned long copy_to_user(void *to, const void *from, unsigned long length)
+{
+	memcpy(to, from, length);
+	return 0;
+}
+
+static inline unsigned long copy_from_user(void *to, const void *from, unsigned long length)
+{
+	memcpy(to, from, length);
+	return 0;
+}
+
+#endif
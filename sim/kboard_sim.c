@@ -0,0 +1,298 @@
+#include "kboard_compat.h"
+#include "kboard_sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lab1/kernel/kboard_ring.h"
+#include "../lab1/kernel/kboard_stack.h"
+#include "../lab1/user/kboard.h"
+
+#ifndef SYNC_SOLUTION
+#define SYNC_SOLUTION 1
+#endif
+
+#include "../lab2/KboardSync.h"
+
+// lab1 클립보드: os_kboard.c 와 같이 spinlock 으로 보호
+static spinlock_t Lock;
+static struct kb_prio_ring Clipboard;
+static int Mode;
+static struct kb_stat Stat;
+static struct kb_stack Stack;
+static long StackCopied;
+static long StackPasted;
+
+// lab2 Kboard: KboardModule.c 와 같은 링 버퍼를 Readers-Writers 솔루션으로 보호
+KB_RING_DEFINE(KboardRing, int, MAX_CLIP, INIT_VALUE, NONE)
+
+static struct KboardRing RingBuffer;
+static long PerformWriter;
+static long PerformReader;
+
+// 쓰레드별 난수 상태, rand()의 내부 lock 으로 인한 경합을 피함
+static __thread unsigned int RandomSeed;
+
+// 우선순위를 지정하여 클립보드에 복사, do_sys_kb_enqueue_prio()와 같은 동작
+long kboard_copy_prio(int clip, int priority)
+{
+	return kboard_copy_ttl(clip, priority, 0);
+}
+
+// 시뮬레이터의 jiffies, 밀리초 단위
+static unsigned long SimulatorJiffies(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (unsigned long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// TTL 을 지정하여 클립보드에 복사, do_sys_kb_enqueue_ttl()과 같은 동작
+// 백그라운드 타이머는 없으므로 만료된 값은 붙여넣기 할 때 맨 앞에서만 제거됨
+long kboard_copy_ttl(int clip, int priority, int ttl)
+{
+	unsigned long expires = 0;
+
+	if (clip < 0 || priority < 0 || priority >= KB_PRIO_LEVELS || ttl < 0)
+	{
+		return -2;
+	}
+
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		if (kb_stack_push(&Stack, clip) != 0)
+		{
+			return -1;
+		}
+		__atomic_fetch_add(&StackCopied, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	if (ttl > 0)
+	{
+		expires = SimulatorJiffies() + ttl;
+	}
+
+	spin_lock(&Lock);
+
+	if (kb_ring_is_full(&Clipboard.Level[priority]))
+	{
+		if ((Mode & KB_MODE_OVERWRITE) == 0)
+		{
+			spin_unlock(&Lock);
+			return -1;
+		}
+
+		kb_prio_ring_pop(&Clipboard, priority);
+		Stat.Dropped++;
+	}
+
+	kb_prio_ring_push_expires(&Clipboard, priority, clip, expires);
+	Stat.Copied++;
+
+	spin_unlock(&Lock);
+
+	return 0;
+}
+
+// 클립보드에 복사, do_sys_kb_enqueue()와 같은 동작
+long kboard_copy(int clip)
+{
+	return kboard_copy_prio(clip, KB_PRIO_DEFAULT);
+}
+
+// 클립보드의 값을 붙여넣기, do_sys_kb_dequeue()와 같은 동작
+int kboard_paste(int *clip)
+{
+	int priority;
+
+	if ((READ_ONCE(Mode) & KB_MODE_LIFO) != 0)
+	{
+		if (kb_stack_pop(&Stack, clip) != 0)
+		{
+			return -1;
+		}
+		__atomic_fetch_add(&StackPasted, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	spin_lock(&Lock);
+
+	while ((priority = kb_prio_ring_highest(&Clipboard)) >= 0 &&
+		kb_expired(kb_ring_front(&Clipboard.Level[priority])->Expires, SimulatorJiffies()))
+	{
+		kb_prio_ring_pop(&Clipboard, priority);
+		Stat.Expired++;
+	}
+
+	if (priority < 0)
+	{
+		spin_unlock(&Lock);
+		return -1;
+	}
+
+	*clip = kb_ring_front(&Clipboard.Level[priority])->Item;
+	kb_prio_ring_pop(&Clipboard, priority);
+	Stat.Pasted++;
+
+	spin_unlock(&Lock);
+
+	return 0;
+}
+
+// 클립보드 초기화, do_sys_kb_init()과 같은 동작
+void kboard_init()
+{
+	spin_lock_init(&Lock);
+	spin_lock(&Lock);
+	kb_prio_ring_init(&Clipboard);
+	Mode = 0;
+	memset(&Stat, 0, sizeof(Stat));
+	kb_stack_init(&Stack);
+	StackCopied = 0;
+	StackPasted = 0;
+	spin_unlock(&Lock);
+}
+
+// 클립보드 동작 방식 설정, do_sys_kb_set_mode()와 같은 동작
+long kboard_set_mode(int mode)
+{
+	if ((mode & ~KB_MODE_MASK) != 0)
+	{
+		return -2;
+	}
+
+	spin_lock(&Lock);
+	WRITE_ONCE(Mode, mode);
+	spin_unlock(&Lock);
+
+	return 0;
+}
+
+// 클립보드 통계, do_sys_kb_stat()과 같은 동작
+long kboard_stat(struct kb_stat *stat)
+{
+	int level;
+	long stackCopied;
+	long stackPasted;
+
+	spin_lock(&Lock);
+	*stat = Stat;
+	stat->Count = 0;
+	for (level = 0; level < KB_PRIO_LEVELS; level++)
+	{
+		stat->Count += Clipboard.Level[level].Count;
+	}
+	stat->Mode = Mode;
+	spin_unlock(&Lock);
+
+	stackPasted = __atomic_load_n(&StackPasted, __ATOMIC_RELAXED);
+	stackCopied = __atomic_load_n(&StackCopied, __ATOMIC_RELAXED);
+	stat->Copied += stackCopied;
+	stat->Pasted += stackPasted;
+	stat->Count += stackCopied - stackPasted;
+
+	return 0;
+}
+
+void kboard_sim_init(void)
+{
+	KboardRing_init(&RingBuffer);
+	PerformWriter = 0;
+	PerformReader = 0;
+	InitializeSyncSolution();
+}
+
+void kboard_sim_set_delay(int milliseconds)
+{
+	PerformDelay = milliseconds;
+}
+
+// KboardWriter_Write()와 같은 동작
+long kboard_sim_enqueue(int item)
+{
+	if (item < 0)
+	{
+		return -2;
+	}
+
+	EnterCriticalSection_Writer();
+	mdelay(PerformDelay);
+	PerformWriter++;
+
+	if (KboardRing_is_full(&RingBuffer))
+	{
+		LeaveCriticalSection_Writer();
+		return -1;
+	}
+
+	KboardRing_push(&RingBuffer, item);
+
+	LeaveCriticalSection_Writer();
+
+	return 0;
+}
+
+// KboardWriter_Show()와 같은 동작
+long kboard_sim_dequeue(int *item)
+{
+	EnterCriticalSection_Writer();
+	mdelay(PerformDelay);
+	PerformWriter++;
+
+	if (KboardRing_is_empty(&RingBuffer))
+	{
+		LeaveCriticalSection_Writer();
+		return -1;
+	}
+
+	*item = *KboardRing_front(&RingBuffer);
+	KboardRing_pop(&RingBuffer);
+
+	LeaveCriticalSection_Writer();
+
+	return 0;
+}
+
+// KboardSampleBatch()와 같은 동작, 값이 들어있는 칸들 중 하나를 쓰레드별 난수로 고름
+// 커널의 reciprocal_scale(prandom_u32_state(), Count)처럼 나눗셈 없이 난수를 [0, Count) 로 줄임
+long kboard_sim_sample(int *item)
+{
+	unsigned int offset;
+
+	if (RandomSeed == 0)
+	{
+		RandomSeed = (unsigned int)(unsigned long)&offset | 1;
+	}
+
+	EnterCriticalSection_Reader();
+	mdelay(PerformDelay);
+	__atomic_fetch_add(&PerformReader, 1, __ATOMIC_RELAXED);
+
+	if (KboardRing_is_empty(&RingBuffer))
+	{
+		LeaveCriticalSection_Reader();
+		return -1;
+	}
+
+	// rand_r()는 31 비트이므로 31 비트만큼 내림
+	offset = (unsigned int)(((unsigned long long)rand_r(&RandomSeed) * (unsigned int)RingBuffer.Count) >> 31);
+	*item = *KboardRing_at(&RingBuffer, offset);
+
+	LeaveCriticalSection_Reader();
+
+	return 0;
+}
+
+int kboard_sim_sync_solution(void)
+{
+	return SYNC_SOLUTION;
+}
+
+void kboard_sim_perform(long *writer, long *reader)
+{
+	*writer = PerformWriter;
+	*reader = __atomic_load_n(&PerformReader, __ATOMIC_RELAXED);
+}
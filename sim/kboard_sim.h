@@ -0,0 +1,43 @@
+#pragma once
+
+// Kboard 유저 공간 시뮬레이터
+// lab1 의 클립보드(kboard.h 의 kboard_copy, kboard_paste, kboard_init)도 함께 구현하므로
+// lab1/user 의 프로그램을 kboard.c 대신 이 라이브러리와 링크하면 커널 없이 실행됨
+//
+// 자료구조와 동기화는 커널과 같은 헤더를 그대로 컴파일하므로 항상 일치
+//   kboard_ring.h (kboard_ring_generic.h), kboard_stack.h, KboardSync.h
+// 시스템 콜과 모듈 함수의 흐름은 공유할 수 없어 kboard_sim.c 에 옮겨 적었으며 아래 동작만 모델링
+// 커널 쪽 흐름을 바꾸면 kboard_sim.c 와 이 설명도 함께 고쳐야 함
+//
+// lab1 클립보드 (os_kboard.c)
+//   모델링: 복사와 붙여넣기 (우선순위, TTL, 덮어쓰기 모드 포함) 는 하나의 spinlock 안에서, LIFO 모드는 잠금 없는 스택으로 처리
+//           음수 값은 -2, 가득 참과 비어 있음은 -1 로 시스템 콜과 같은 값을 반환
+//   제외: TTL 백그라운드 타이머 (만료된 값은 붙여넣기 할 때 맨 앞에서만 제거), 키 저장소, 로그,
+//         공유 메모리 큐, 잠드는 붙여넣기와 알림 모으기, BPF 필터 (필터가 없을 때처럼 음수 값만 거부)
+//
+// lab2 Kboard (KboardModule.c)
+//   모델링: Enqueue, Dequeue 는 Writer 로, Sample 은 Reader 로 Critical Section 에 들어가 mdelay 뒤 링 버퍼를 한 번 변경
+//           Sample 은 값이 들어있는 칸 중 하나를 쓰레드별 난수로 고르고 비어 있으면 -1
+//   제외: 백로그 (가득 차면 바로 -1), 용량 변경 (MAX_CLIP 크기의 고정 링 버퍼), 중복 제거, mmap 미러,
+//         Generic Netlink 알림, 배치와 iov_iter 경로, BPF 필터, 대기 시간 통계
+
+// lab2 Kboard 초기화, 링 버퍼와 SYNC_SOLUTION 에 따른 세마포어를 초기화
+void kboard_sim_init(void);
+
+// Critical Section 안에서 수행할 작업 시간 (ms), 기본값은 SYNC_SOLUTION 별 커널 모듈 값과 같음
+void kboard_sim_set_delay(int milliseconds);
+
+// Writer: 링 버퍼에 값을 넣음, 성공 0, 음수 값 -2, 가득 참 -1
+long kboard_sim_enqueue(int item);
+
+// Writer: 링 버퍼에서 값을 꺼냄, 성공 0, 비어 있음 -1
+long kboard_sim_dequeue(int *item);
+
+// Reader: 링 버퍼의 값이 들어있는 칸 하나를 무작위로 읽음, 성공 0, 비어 있음 -1
+long kboard_sim_sample(int *item);
+
+// 빌드에 사용된 SYNC_SOLUTION
+int kboard_sim_sync_solution(void);
+
+// Writer, Reader 수행 횟수
+void kboard_sim_perform(long *writer, long *reader);
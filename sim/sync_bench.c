@@ -0,0 +1,163 @@
+#include "kboard_sim.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// lab2/SyncTest.c 와 같은 작업을 시뮬레이터에 대해 수행하고 결과를 CSV 로 출력
+// Writer 의 절반은 Enqueue, 나머지는 Dequeue, Reader 는 무작위 값을 읽음
+
+struct ThreadStat
+{
+	long long success;
+	long long retry;
+};
+
+static atomic_bool Running;
+
+void *WriterEnqueue(void *argument);
+void *WriterDequeue(void *argument);
+void *Reader(void *argument);
+
+int main(int argc, char *argv[])
+{
+	int index;
+	int writerEnqueueNumber, writerDequeueNumber, readerNumber;
+	int threadNumber;
+	int duration;
+	pthread_t *threads;
+	struct ThreadStat *stats;
+	long long enqueue = 0, dequeue = 0, read = 0;
+	long long fullRetry = 0, emptyRetry = 0;
+	long performWriter, performReader;
+
+	if (argc < 4)
+	{
+		printf("Writer, Reader의 수와 수행 시간(초)을 입력하세요 [Critical Section 지연(ms)]\n");
+		return -1;
+	}
+
+	writerEnqueueNumber = atoi(argv[1]) / 2;
+	writerDequeueNumber = atoi(argv[1]) - (atoi(argv[1]) / 2);
+	readerNumber = atoi(argv[2]);
+	duration = atoi(argv[3]);
+	threadNumber = writerEnqueueNumber + writerDequeueNumber + readerNumber;
+
+	kboard_sim_init();
+	if (argc > 4)
+	{
+		kboard_sim_set_delay(atoi(argv[4]));
+	}
+
+	threads = malloc(sizeof(pthread_t) * threadNumber);
+	stats = calloc(threadNumber, sizeof(struct ThreadStat));
+
+	atomic_store(&Running, true);
+	for (index = 0; index < threadNumber; index++)
+	{
+		if (index < writerEnqueueNumber)
+		{
+			pthread_create(&threads[index], NULL, WriterEnqueue, &stats[index]);
+		}
+		else if (index < writerEnqueueNumber + writerDequeueNumber)
+		{
+			pthread_create(&threads[index], NULL, WriterDequeue, &stats[index]);
+		}
+		else
+		{
+			pthread_create(&threads[index], NULL, Reader, &stats[index]);
+		}
+	}
+
+	// 목표 수행 시간동안 대기
+	usleep(duration * 1000 * 1000);
+	atomic_store(&Running, false);
+
+	for (index = 0; index < threadNumber; index++)
+	{
+		pthread_join(threads[index], NULL);
+
+		if (index < writerEnqueueNumber)
+		{
+			enqueue += stats[index].success;
+			fullRetry += stats[index].retry;
+		}
+		else if (index < writerEnqueueNumber + writerDequeueNumber)
+		{
+			dequeue += stats[index].success;
+			emptyRetry += stats[index].retry;
+		}
+		else
+		{
+			read += stats[index].success;
+		}
+	}
+
+	kboard_sim_perform(&performWriter, &performReader);
+
+	printf("sync_solution,enqueue_writers,dequeue_writers,readers,seconds,enqueue_ops,dequeue_ops,read_ops,"
+		"full_retry,empty_retry,perform_writer,perform_reader\n");
+	printf("%d,%d,%d,%d,%d,%lld,%lld,%lld,%lld,%lld,%ld,%ld\n",
+		kboard_sim_sync_solution(), writerEnqueueNumber, writerDequeueNumber, readerNumber, duration,
+		enqueue, dequeue, read, fullRetry, emptyRetry, performWriter, performReader);
+
+	free(threads);
+	free(stats);
+
+	return 0;
+}
+
+// Writer: Kboard Enqueue 작업
+void *WriterEnqueue(void *argument)
+{
+	struct ThreadStat *stat = argument;
+
+	while (atomic_load_explicit(&Running, memory_order_relaxed))
+	{
+		if (kboard_sim_enqueue(777) != 0)
+		{
+			stat->retry++;
+			continue;
+		}
+		stat->success++;
+	}
+
+	return NULL;
+}
+
+// Writer: Kboard Dequeue 작업
+void *WriterDequeue(void *argument)
+{
+	struct ThreadStat *stat = argument;
+	int item;
+
+	while (atomic_load_explicit(&Running, memory_order_relaxed))
+	{
+		if (kboard_sim_dequeue(&item) != 0)
+		{
+			stat->retry++;
+			continue;
+		}
+		stat->success++;
+	}
+
+	return NULL;
+}
+
+// Reader: Kboard 의 Queue 에 있는 무작위 값 읽기
+void *Reader(void *argument)
+{
+	struct ThreadStat *stat = argument;
+	int item;
+
+	while (atomic_load_explicit(&Running, memory_order_relaxed))
+	{
+		kboard_sim_sample(&item);
+		stat->success++;
+	}
+
+	return NULL;
+}